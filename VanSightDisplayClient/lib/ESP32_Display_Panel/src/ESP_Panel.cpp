@@ -236,6 +236,9 @@ void ESP_Panel::init(void)
     lcd_bus = new CREATE_BUS_INIT_HOST(ESP_PANEL_LCD_BUS_NAME, &lcd_panel_io_cfg, &lcd_bus_host_cfg, ESP_PANEL_LCD_BUS_HOST);
 #endif /* ESP_PANEL_LCD_BUS_SKIP_INIT_HOST */
     CHECK_NULL_RETURN(lcd_bus);
+#if (ESP_PANEL_LCD_BUS_TYPE == ESP_PANEL_BUS_TYPE_RGB) && (ESP_PANEL_LCD_RGB_BOUNCE_BUF_SIZE > 0)
+    static_cast<ESP_PanelBus_RGB *>(lcd_bus)->setBounceBufferSize(ESP_PANEL_LCD_RGB_BOUNCE_BUF_SIZE);
+#endif
     lcd = new CREATE_LCD(ESP_PANEL_LCD_NAME, lcd_bus, &lcd_cfg);
     CHECK_NULL_RETURN(lcd);
 #endif /* ESP_PANEL_USE_LCD */
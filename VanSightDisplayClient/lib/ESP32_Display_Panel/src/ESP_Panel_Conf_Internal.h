@@ -358,6 +358,14 @@
             #endif
         #endif
 
+        #ifndef ESP_PANEL_LCD_RGB_BOUNCE_BUF_SIZE
+            #ifdef CONFIG_ESP_PANEL_LCD_RGB_BOUNCE_BUF_SIZE
+                #define ESP_PANEL_LCD_RGB_BOUNCE_BUF_SIZE   CONFIG_ESP_PANEL_LCD_RGB_BOUNCE_BUF_SIZE
+            #else
+                #define ESP_PANEL_LCD_RGB_BOUNCE_BUF_SIZE   (0)
+            #endif
+        #endif
+
         #ifndef ESP_PANEL_LCD_RGB_IO_DATA0
             #ifdef CONFIG_ESP_PANEL_LCD_RGB_IO_DATA0
                 #define ESP_PANEL_LCD_RGB_IO_DATA0  CONFIG_ESP_PANEL_LCD_RGB_IO_DATA0
@@ -79,6 +79,17 @@ const esp_lcd_rgb_panel_config_t *ESP_PanelBus_RGB::getRGBConfig()
     return &rgb_config;
 }
 
+void ESP_PanelBus_RGB::setBounceBufferSize(size_t size_px)
+{
+#if ESP_PANELBUS_RGB_BOUNCE_BUF_SUPPORTED
+    rgb_config.bounce_buffer_size_px = size_px;
+#else
+    if (size_px) {
+        ESP_LOGW(TAG, "Bounce buffer needs ESP-IDF >= v5.0, ignored");
+    }
+#endif
+}
+
 void ESP_PanelBus_RGB::init(void)
 {
     if (flags.host_need_init) {
@@ -12,12 +12,16 @@
 
 #include <stdint.h>
 
+#include "esp_idf_version.h"
 #include "esp_lcd_panel_rgb.h"
 #include "ESP_IOExpander.h"
 
 #include "base/esp_lcd_panel_io_additions.h"
 #include "../ESP_PanelBus.h"
 
+/* Bounce buffers (`bounce_buffer_size_px`) are available since ESP-IDF v5.0 */
+#define ESP_PANELBUS_RGB_BOUNCE_BUF_SUPPORTED   (ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0))
+
 #define RGB_TIMING_CONFIG_DEFAULT(width, height)            \
     {                                                       \
         .pclk_hz = 16 * 1000 * 1000,                        \
@@ -88,6 +92,18 @@ public:
 
     const esp_lcd_rgb_panel_config_t *getRGBConfig();
 
+    /**
+     * @brief Use bounce buffers between the PSRAM frame buffer and the LCD peripheral
+     *
+     * The peripheral then reads internal RAM chunks that the CPU refills from
+     * PSRAM, which keeps the panel stable when WiFi or BLE load the PSRAM bus.
+     * Must be called before the LCD is initialized. Ignored (with a warning)
+     * when the ESP-IDF version has no bounce buffer support.
+     *
+     * @param size_px Bounce buffer size in pixels, must divide H_RES * V_RES (0 = disable)
+     */
+    void setBounceBufferSize(size_t size_px);
+
     void init(void) override;
 
 private:
@@ -120,6 +120,10 @@
     #define ESP_PANEL_LCD_RGB_IO_DATA14         (41)
     #define ESP_PANEL_LCD_RGB_IO_DATA15         (40)
     #define ESP_PANEL_LCD_RGB_IO_DISP           (-1)
+    #define ESP_PANEL_LCD_RGB_BOUNCE_BUF_SIZE   (0)     // Bounce buffer size in pixels, e.g. (ESP_PANEL_LCD_H_RES * 10).
+                                                        // Moves the PSRAM reads of the frame buffer into internal RAM
+                                                        // chunks so WiFi/BLE traffic does not starve the panel.
+                                                        // Set to 0 to disable. Needs ESP-IDF >= 5.0.
 #if !ESP_PANEL_LCD_BUS_SKIP_INIT_HOST
     #define ESP_PANEL_LCD_SPI_CLK_HZ            (500 * 1000)
     #define ESP_PANEL_LCD_SPI_MODE              (0)
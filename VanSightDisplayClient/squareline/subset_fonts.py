@@ -0,0 +1,376 @@
+#!/usr/bin/env python3
+"""
+SquareLine Font Subsetter
+Trims the lv_font_conv icon fonts to the glyphs the UI actually uses.
+
+The full fonts exported by SquareLine Studio stay in squareline/assets/fonts.
+Every build scans the UI sources for string literals, keeps only the glyphs
+that appear in them and writes trimmed copies of the icon fonts next to the
+UI sources. A character that no font provides stops the build.
+
+Usage:
+  python3 subset_fonts.py                    # lib/ui and the simulator's ui/src
+  python3 subset_fonts.py --scan DIR --out DIR [--keep U+F0E7 ...]
+
+Also runs as a PlatformIO pre-script (extra_scripts = pre:squareline/subset_fonts.py).
+"""
+
+import argparse
+import glob
+import os
+import re
+import sys
+
+# Icon fonts that get trimmed; text fonts are small and kept whole.
+# ASCII is drawn by the text fonts, so only non-ASCII characters (and
+# --keep glyphs) are kept in the icon fonts.
+SUBSET_FONTS = ["ui_font_FontAwsome7Solid", "ui_font_fasolid"]
+LAST_ASCII = 0x7E
+
+# Log calls; their strings are never drawn
+LOG_CALL = re.compile(r"\b(Serial\.\w+|f?printf|puts|ESP_LOG\w)\s*\(")
+
+SOURCE_PATTERNS = ("*.c", "*.cpp", "*.h")
+GLYPH_DSC_SIZE = 8      # sizeof(lv_font_fmt_txt_glyph_dsc_t)
+CMAP_SIZE = 20          # sizeof(lv_font_fmt_txt_cmap_t) on a 32-bit target
+
+
+class SubsetError(Exception):
+    pass
+
+
+# ============================================================================
+# UI SOURCE SCANNING
+# ============================================================================
+
+def decode_literal(body):
+    """Decode the contents of a C string literal to text"""
+    out = bytearray()
+    i = 0
+    while i < len(body):
+        c = body[i]
+        if c != "\\":
+            out += c.encode("utf-8")
+            i += 1
+            continue
+
+        nxt = body[i + 1]
+        if nxt == "x":
+            m = re.match(r"[0-9a-fA-F]+", body[i + 2:])
+            out.append(int(m.group(0), 16) & 0xFF)
+            i += 2 + len(m.group(0))
+        elif nxt in "01234567":
+            m = re.match(r"[0-7]{1,3}", body[i + 1:])
+            out.append(int(m.group(0), 8) & 0xFF)
+            i += 1 + len(m.group(0))
+        elif nxt in "uU":
+            digits = 4 if nxt == "u" else 8
+            out += chr(int(body[i + 2:i + 2 + digits], 16)).encode("utf-8")
+            i += 2 + digits
+        else:
+            out += {"n": "\n", "t": "\t", "r": "\r", "0": "\0"}.get(nxt, nxt).encode("utf-8")
+            i += 2
+    return out.decode("utf-8")
+
+
+def string_literals(text):
+    """Yield (line, literal) for every string literal outside comments and #include lines"""
+    i = 0
+    line = 1
+    n = len(text)
+    while i < n:
+        c = text[i]
+        if c == "\n":
+            line += 1
+            i += 1
+        elif text.startswith("//", i):
+            i = text.find("\n", i)
+            i = n if i < 0 else i
+        elif text.startswith("/*", i):
+            end = text.find("*/", i + 2)
+            end = n if end < 0 else end + 2
+            line += text.count("\n", i, end)
+            i = end
+        elif c == "#" and re.match(r"#\s*include", text[i:i + 32]):
+            i = text.find("\n", i)
+            i = n if i < 0 else i
+        elif c in "\"'":
+            j = i + 1
+            while j < n and text[j] != c:
+                j += 2 if text[j] == "\\" else 1
+            if c == '"':
+                yield line, text[i + 1:j]
+            i = j + 1
+        else:
+            i += 1
+
+
+def scan_sources(dirs):
+    """Map every character used in string literals to the places it is used"""
+    used = {}
+    for directory in dirs:
+        for pattern in SOURCE_PATTERNS:
+            for path in sorted(glob.glob(os.path.join(directory, pattern))):
+                if os.path.basename(path).startswith("ui_font_"):
+                    continue
+                with open(path, encoding="utf-8") as f:
+                    text = f.read()
+                lines = text.split("\n")
+                for line, literal in string_literals(text):
+                    if LOG_CALL.search(lines[line - 1]):
+                        continue
+                    try:
+                        decoded = decode_literal(literal)
+                    except (UnicodeDecodeError, ValueError, AttributeError, IndexError):
+                        raise SubsetError(f"{path}:{line}: cannot decode string literal")
+                    for ch in decoded:
+                        if ord(ch) > 0x20:
+                            used.setdefault(ord(ch), []).append(f"{os.path.relpath(path)}:{line}")
+    return used
+
+
+# ============================================================================
+# LV_FONT_CONV FONT FILES
+# ============================================================================
+
+class Font:
+    """A font file written by lv_font_conv (--format lvgl, no kerning)"""
+
+    def __init__(self, path):
+        self.path = path
+        self.name = os.path.splitext(os.path.basename(path))[0]
+        with open(path, encoding="utf-8") as f:
+            self.text = f.read()
+
+        t = self.text
+        self.b0 = self._after("glyph_bitmap[] = {\n")
+        self.b1 = t.index("\n};", self.b0)
+        self.d0 = self._after("glyph_dsc[] = {\n")
+        self.d1 = t.index("\n};", self.d0)
+        self.c0 = t.rfind("/*", 0, t.index(" *  CHARACTER MAPPING"))
+        self.a0 = t.rfind("/*", 0, t.index(" *  ALL CUSTOM DATA"))
+
+        bitmap = t[self.b0:self.b1]
+        self.comments = re.findall(r"^\s*(/\* U\+([0-9A-F]+) .*\*/)$", bitmap, re.M)
+        self.codepoints = [int(cp, 16) for _, cp in self.comments]
+        self.bitmap = [int(b, 16) for b in re.findall(r"0x[0-9a-fA-F]+", re.sub(r"/\*.*?\*/", "", bitmap))]
+
+        self.dsc = [l.strip().rstrip(",") for l in t[self.d0:self.d1].split("\n") if l.strip()]
+        self.index = [int(re.search(r"\.bitmap_index = (\d+)", d).group(1)) for d in self.dsc]
+
+        if len(self.dsc) != len(self.codepoints) + 1:
+            raise SubsetError(f"{path}: {len(self.codepoints)} glyphs but {len(self.dsc) - 1} descriptors")
+
+    def _after(self, marker):
+        pos = self.text.find(marker)
+        if pos < 0:
+            raise SubsetError(f"{self.path}: '{marker.strip()}' not found, not an lv_font_conv font")
+        return pos + len(marker)
+
+    def has_kerning(self):
+        return ".kern_dsc = NULL" not in self.text
+
+    def glyph_bytes(self, gid):
+        """Bitmap bytes of glyph gid (1-based)"""
+        end = self.index[gid + 1] if gid + 1 < len(self.index) else len(self.bitmap)
+        return self.bitmap[self.index[gid]:end]
+
+    def data_size(self):
+        """Approximate flash taken by the glyph data and character maps"""
+        size = len(self.bitmap) + GLYPH_DSC_SIZE * len(self.dsc)
+        charmap = self.text[self.c0:self.a0]
+        for ctype, body in re.findall(r"static const (uint8_t|uint16_t) \w+\[\] = \{(.*?)\};", charmap, re.S):
+            size += body.count(",") + 1 if ctype == "uint8_t" else 2 * (body.count(",") + 1)
+        return size + CMAP_SIZE * charmap.count(".range_start")
+
+
+def hex_lines(values, indent="    "):
+    """Format values like lv_font_conv: eight per line"""
+    rows = [", ".join(f"0x{v:x}" for v in values[i:i + 8]) for i in range(0, len(values), 8)]
+    return (",\n").join(indent + r for r in rows)
+
+
+def subset(font, keep):
+    """Build the trimmed font source; returns (text, glyph count, data size)"""
+    glyphs = [(cp, gid) for gid, cp in enumerate(font.codepoints, 1) if cp in keep]
+
+    # Bitmaps and descriptors, renumbered in codepoint order
+    blocks = []
+    dsc = [font.dsc[0]]
+    bitmap_size = 0
+    for cp, gid in glyphs:
+        data = font.glyph_bytes(gid)
+        block = "    " + font.comments[gid - 1][0]
+        if data:
+            block += "\n" + hex_lines(data)
+        blocks.append(block)
+        dsc.append(re.sub(r"\.bitmap_index = \d+", f".bitmap_index = {bitmap_size}", font.dsc[gid]))
+        bitmap_size += len(data)
+    bitmap_text = ",\n\n".join(blocks) if blocks else "    0x0"
+
+    # Character maps: sparse lists of 16-bit offsets, one per 64K span
+    groups = []
+    for cp, _ in glyphs:
+        if groups and cp - groups[-1][0] <= 0xFFFF:
+            groups[-1].append(cp)
+        else:
+            groups.append([cp])
+
+    lists = ""
+    cmaps = []
+    glyph_id = 1
+    for n, group in enumerate(groups):
+        start = group[0]
+        length = group[-1] - start + 1
+        if length == len(group):
+            cmaps.append(f"        .range_start = {start}, .range_length = {length}, .glyph_id_start = {glyph_id},\n"
+                         f"        .unicode_list = NULL, .glyph_id_ofs_list = NULL, .list_length = 0, "
+                         f".type = LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY")
+        else:
+            lists += (f"static const uint16_t unicode_list_{n}[] = {{\n"
+                      f"{hex_lines([cp - start for cp in group])}\n}};\n\n")
+            cmaps.append(f"        .range_start = {start}, .range_length = {length}, .glyph_id_start = {glyph_id},\n"
+                         f"        .unicode_list = unicode_list_{n}, .glyph_id_ofs_list = NULL, "
+                         f".list_length = {len(group)}, .type = LV_FONT_FMT_TXT_CMAP_SPARSE_TINY")
+        glyph_id += len(group)
+
+    charmap = "/*---------------------\n *  CHARACTER MAPPING\n *--------------------*/\n\n"
+    if cmaps:
+        charmap += (lists + "/*Collect the unicode lists and glyph_id offsets*/\n"
+                    "static const lv_font_fmt_txt_cmap_t cmaps[] =\n{\n"
+                    + ",\n".join("    {\n" + c + "\n    }" for c in cmaps) + "\n};\n")
+    charmap += "\n\n\n"
+
+    tail = font.text[font.a0:]
+    tail = re.sub(r"\.cmap_num = \d+", f".cmap_num = {len(cmaps)}", tail)
+    if not cmaps:
+        tail = tail.replace(".cmaps = cmaps", ".cmaps = NULL")
+
+    head = font.text[:font.b0]
+    note = (f" * Subset: {len(glyphs)} of {len(font.codepoints)} glyphs, "
+            f"generated by squareline/subset_fonts.py - do not edit\n")
+    head = head.replace("\n ****", "\n" + note.rstrip("\n") + "\n ****", 1)
+
+    text = (head + bitmap_text + font.text[font.b1:font.d0]
+            + ",\n".join("    " + d for d in dsc) + font.text[font.d1:font.c0]
+            + charmap + tail)
+
+    size = max(bitmap_size, 1) + GLYPH_DSC_SIZE * len(dsc) + CMAP_SIZE * len(cmaps)
+    size += sum(2 * len(g) for g in groups if g[-1] - g[0] + 1 != len(g))
+    return text, len(glyphs), size
+
+
+# ============================================================================
+# MAIN
+# ============================================================================
+
+def parse_codepoint(value):
+    value = value.upper()
+    for prefix in ("U+", "0X"):
+        if value.startswith(prefix):
+            return int(value[len(prefix):], 16)
+    return int(value, 16)
+
+
+def run(fonts_dir, scan_dirs, out_dirs, keep_codepoints):
+    print("🔤 Subsetting icon fonts...")
+
+    fonts = {}
+    for path in sorted(glob.glob(os.path.join(fonts_dir, "ui_font_*.c"))):
+        font = Font(path)
+        fonts[font.name] = font
+
+    missing_fonts = [name for name in SUBSET_FONTS if name not in fonts]
+    if missing_fonts:
+        raise SubsetError(f"font source not found in {fonts_dir}: {', '.join(missing_fonts)}")
+
+    used = scan_sources(scan_dirs)
+    for cp in keep_codepoints:
+        used.setdefault(cp, []).append("--keep")
+    keep = set(cp for cp in used if cp > LAST_ASCII) | set(keep_codepoints)
+
+    # Every kept character must be drawn by some font
+    coverage = set()
+    for font in fonts.values():
+        coverage.update(font.codepoints)
+    missing = sorted(cp for cp in keep if cp not in coverage)
+    if missing:
+        details = "\n".join(f"   U+{cp:04X} used at {', '.join(used[cp][:3])}" for cp in missing)
+        raise SubsetError(f"{len(missing)} glyph(s) missing from every font in {fonts_dir}:\n{details}")
+
+    total_before = 0
+    total_after = 0
+    for name in SUBSET_FONTS:
+        font = fonts[name]
+        if font.has_kerning():
+            raise SubsetError(f"{font.path}: kerning is not supported, export without kerning")
+
+        text, count, after = subset(font, keep)
+        before = font.data_size()
+        total_before += before
+        total_after += after
+        print(f"  • {name}: {count}/{len(font.codepoints)} glyphs, "
+              f"{before:,} -> {after:,} bytes ({before - after:,} saved)")
+
+        for out_dir in out_dirs:
+            out_path = os.path.join(out_dir, name + ".c")
+            current = None
+            if os.path.exists(out_path):
+                with open(out_path, encoding="utf-8") as f:
+                    current = f.read()
+            # Only touch the file when it changes, so builds stay incremental
+            if current != text:
+                with open(out_path, "w", encoding="utf-8") as f:
+                    f.write(text)
+                print(f"    ✓ wrote {os.path.relpath(out_path)}")
+
+    print(f"📊 Font data: {total_before:,} -> {total_after:,} bytes ({total_before - total_after:,} saved)")
+
+
+def default_dirs(client_dir):
+    simulator_ui = os.path.join(client_dir, "..", "VanSightDisplaySimulator", "ui", "src")
+    scan = [os.path.join(client_dir, "lib", "ui"), os.path.join(client_dir, "src")]
+    out = [os.path.join(client_dir, "lib", "ui")]
+    if os.path.isdir(simulator_ui):
+        out.append(os.path.normpath(simulator_ui))
+    return scan, out
+
+
+def main(argv):
+    client_dir = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    scan, out = default_dirs(client_dir)
+
+    parser = argparse.ArgumentParser(description="Trim SquareLine icon fonts to the glyphs the UI uses")
+    parser.add_argument("--fonts", default=os.path.join(client_dir, "squareline", "assets", "fonts"),
+                        help="directory with the full lv_font_conv fonts")
+    parser.add_argument("--scan", action="append", help="directory with UI sources to scan (repeatable)")
+    parser.add_argument("--out", action="append", help="directory to write trimmed fonts to (repeatable)")
+    parser.add_argument("--keep", action="append", default=[], metavar="U+XXXX",
+                        help="also keep a glyph that is only set at runtime (repeatable)")
+    args = parser.parse_args(argv)
+
+    try:
+        run(args.fonts, args.scan or scan, args.out or out, [parse_codepoint(k) for k in args.keep])
+    except SubsetError as e:
+        print(f"❌ Font subsetting failed: {e}", file=sys.stderr)
+        return 1
+    return 0
+
+
+try:
+    Import("env")  # noqa: F821 - defined when run by PlatformIO
+except NameError:
+    env = None
+
+if env is not None:
+    # PlatformIO pre-script: trim the fonts in lib/ui before compiling
+    project_dir = env.subst("$PROJECT_DIR")
+    scan, _ = default_dirs(project_dir)
+    try:
+        run(os.path.join(project_dir, "squareline", "assets", "fonts"), scan,
+            [os.path.join(project_dir, "lib", "ui")], [])
+    except SubsetError as e:
+        print(f"❌ Font subsetting failed: {e}")
+        env.Exit(1)
+elif __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
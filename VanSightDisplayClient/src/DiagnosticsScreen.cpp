@@ -0,0 +1,164 @@
+#include "DiagnosticsScreen.h"
+#include "PanelManager.h"
+#include "UIStateManager.h"
+#include <VanSightLib.h>
+#include <ui.h>
+#include <stdarg.h>
+
+using namespace VanSight;
+
+DiagnosticsScreen& DiagnosticsScreen::getInstance() {
+    static DiagnosticsScreen instance;
+    return instance;
+}
+
+DiagnosticsScreen::DiagnosticsScreen()
+    : _screen(nullptr),
+      _label(nullptr),
+      _previous(nullptr),
+      _timer(nullptr) {
+}
+
+DiagnosticsScreen::~DiagnosticsScreen() {
+}
+
+void DiagnosticsScreen::init() {
+    if (!ui_lblTitle) {
+        return;
+    }
+    
+    lv_obj_add_flag(ui_lblTitle, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_event_cb(ui_lblTitle, onTitleLongPress, LV_EVENT_LONG_PRESSED, this);
+    Serial.println("[Diag] Long press the title for diagnostics");
+}
+
+// ============================================================================
+// SCREEN HANDLING (LVGL task)
+// ============================================================================
+
+void DiagnosticsScreen::show() {
+    if (_screen) {
+        return;
+    }
+    
+    // Built on demand so the screen costs no memory while hidden
+    _previous = lv_scr_act();
+    _screen = lv_obj_create(NULL);
+    lv_obj_set_style_bg_color(_screen, lv_color_black(), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_add_event_cb(_screen, onScreenClick, LV_EVENT_CLICKED, this);
+    
+    _label = lv_label_create(_screen);
+    lv_obj_set_style_text_color(_label, lv_color_white(), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_align(_label, LV_ALIGN_TOP_LEFT, 16, 16);
+    
+    refresh();
+    lv_disp_load_scr(_screen);
+    _timer = lv_timer_create(onRefreshTimer, REFRESH_PERIOD_MS, this);
+}
+
+void DiagnosticsScreen::hide() {
+    if (!_screen) {
+        return;
+    }
+    
+    lv_timer_del(_timer);
+    _timer = nullptr;
+    
+    // Called from the screen's own click event, so delete it afterwards
+    lv_disp_load_scr(_previous);
+    lv_obj_del_async(_screen);
+    _screen = nullptr;
+    _label = nullptr;
+}
+
+// Append to a fixed buffer, silently truncating
+static void append(char* text, size_t size, size_t& len, const char* format, ...) {
+    if (len >= size - 1) {
+        return;
+    }
+    
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(text + len, size - len, format, args);
+    va_end(args);
+    
+    if (written > 0) {
+        len = min(len + (size_t)written, size - 1);
+    }
+}
+
+void DiagnosticsScreen::refresh() {
+    if (!_label) {
+        return;
+    }
+    
+    // Sampled from loop(); this only formats the latest record
+    TelemetryRecord record = Telemetry::getInstance().getRecord();
+    
+    char text[1024];
+    size_t len = 0;
+    append(text, sizeof(text), len, "DIAGNOSTICS (tap to close)\n\n");
+    append(text, sizeof(text), len, "Uptime   %lu s\n", (unsigned long)record.uptime);
+    append(text, sizeof(text), len, "Heap     %lu free, %lu min, %lu largest\n",
+           (unsigned long)record.freeHeap, (unsigned long)record.minFreeHeap, (unsigned long)record.largestBlock);
+    append(text, sizeof(text), len, "PSRAM    %lu free\n", (unsigned long)record.freePsram);
+    append(text, sizeof(text), len, "BLE      %s\n",
+           BleCommandManager::getInstance().isConnected() ? "connected" : "disconnected");
+    
+    FrameStats frames = PanelManager::getInstance().getFrameStats();
+    append(text, sizeof(text), len, "Frames   %s, last %lu ms, avg %lu ms, max %lu ms\n", frames.strategy,
+           (unsigned long)frames.lastMs, (unsigned long)frames.avgMs, (unsigned long)frames.maxMs);
+    
+    UIApplyStats ui = UIStateManager::getInstance().getStats();
+    append(text, sizeof(text), len, "UI       %lu redraws, %lu skipped, %lu dropped\n",
+           (unsigned long)ui.redraws, (unsigned long)ui.skipped, (unsigned long)ui.dropped);
+    
+    for (uint8_t bit = 1; bit <= TELEMETRY_WARN_QUEUE; bit <<= 1) {
+        if (record.warnings & bit) {
+            append(text, sizeof(text), len, "WARNING  %s\n", Telemetry::warningName((TelemetryWarning)bit));
+        }
+    }
+    
+    append(text, sizeof(text), len, "\nTask             stack  cpu\n");
+    for (int i = 0; i < record.taskCount; i++) {
+        const TaskTelemetry& task = record.tasks[i];
+        if (task.cpuPercent == 255) {
+            append(text, sizeof(text), len, "%-16s %5u    -\n", task.name, task.stackFree);
+        } else {
+            append(text, sizeof(text), len, "%-16s %5u  %2u%%\n", task.name, task.stackFree, task.cpuPercent);
+        }
+    }
+    
+    // End-to-end latency (UI event to UI apply) per command type
+    append(text, sizeof(text), len, "\nLatency (ms)     n    p50   p99\n");
+    for (int i = 0; i < LatencyMetrics::COMMAND_SLOTS; i++) {
+        LatencyHistogram histogram;
+        LatencyMetrics::getInstance().getHistogram((CommandType)i, STAGE_UI_APPLY, histogram);
+        if (histogram.getCount() == 0) {
+            continue;
+        }
+        append(text, sizeof(text), len, "%-16s %-4lu %5.1f %5.1f\n",
+               commandTypeToString((CommandType)i),
+               (unsigned long)histogram.getCount(),
+               histogram.percentile(50) / 1000.0f,
+               histogram.percentile(99) / 1000.0f);
+    }
+    
+    lv_label_set_text(_label, text);
+}
+
+// ============================================================================
+// LVGL CALLBACKS
+// ============================================================================
+
+void DiagnosticsScreen::onTitleLongPress(lv_event_t* e) {
+    static_cast<DiagnosticsScreen*>(lv_event_get_user_data(e))->show();
+}
+
+void DiagnosticsScreen::onScreenClick(lv_event_t* e) {
+    static_cast<DiagnosticsScreen*>(lv_event_get_user_data(e))->hide();
+}
+
+void DiagnosticsScreen::onRefreshTimer(lv_timer_t* timer) {
+    static_cast<DiagnosticsScreen*>(timer->user_data)->refresh();
+}
@@ -0,0 +1,56 @@
+#ifndef DIAGNOSTICS_SCREEN_H
+#define DIAGNOSTICS_SCREEN_H
+
+#include <Arduino.h>
+#include <lvgl.h>
+
+/**
+ * @brief Hidden diagnostics screen
+ * 
+ * Opened by a long press on the title, closed by tapping anywhere.
+ * Shows the display's resource telemetry and tap-to-UI latencies,
+ * refreshed once per second while visible.
+ */
+class DiagnosticsScreen {
+public:
+    /**
+     * @brief Get singleton instance
+     */
+    static DiagnosticsScreen& getInstance();
+    
+    /**
+     * @brief Attach the long-press trigger (call with the LVGL lock held)
+     */
+    void init();
+    
+    /**
+     * @brief Check if the screen is shown
+     */
+    bool isVisible() const { return _screen != nullptr; }
+    
+private:
+    DiagnosticsScreen();
+    ~DiagnosticsScreen();
+    
+    // Prevent copying
+    DiagnosticsScreen(const DiagnosticsScreen&) = delete;
+    DiagnosticsScreen& operator=(const DiagnosticsScreen&) = delete;
+    
+    lv_obj_t* _screen;
+    lv_obj_t* _label;
+    lv_obj_t* _previous;
+    lv_timer_t* _timer;
+    
+    static const uint32_t REFRESH_PERIOD_MS = 1000;
+    
+    void show();
+    void hide();
+    void refresh();
+    
+    // LVGL callbacks (static for C API)
+    static void onTitleLongPress(lv_event_t* e);
+    static void onScreenClick(lv_event_t* e);
+    static void onRefreshTimer(lv_timer_t* timer);
+};
+
+#endif // DIAGNOSTICS_SCREEN_H
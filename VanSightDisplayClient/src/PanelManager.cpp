@@ -1,6 +1,7 @@
 #include "PanelManager.h"
 #include "SleepManager.h"
 #include <ui.h>
+#include <esp_timer.h>
 
 // Pin definitions
 #define TP_RST 1
@@ -9,6 +10,8 @@
 #define SD_CS 4
 #define USB_SEL 5
 
+#define TP_INT 4    // GPIO, touch controller interrupt (active low)
+
 #define I2C_MASTER_NUM 0
 #define I2C_MASTER_SDA_IO 8
 #define I2C_MASTER_SCL_IO 9
@@ -19,7 +22,29 @@
 #define LVGL_TASK_MIN_DELAY_MS  (1)
 #define LVGL_TASK_STACK_SIZE    (4 * 1024)
 #define LVGL_TASK_PRIORITY      (2)
-#define LVGL_BUF_SIZE           (ESP_PANEL_LCD_H_RES * 20)
+#define LVGL_FLUSH_TASK_STACK   (3 * 1024)
+#define LVGL_FLUSH_TASK_CORE    (0)     // Copy on the other core while LVGL renders
+
+#define LVGL_VSYNC_TIMEOUT_MS   (50)    // Present anyway when no vsync arrives
+
+// Touch
+#define TOUCH_TASK_STACK_SIZE   (3 * 1024)
+#define TOUCH_TASK_PRIORITY     (LVGL_TASK_PRIORITY + 1)
+#define TOUCH_PRESSED_POLL_MS   (40)    // Re-read while pressed in case the release edge is missed
+
+// Draw buffers (override with -D in build_flags)
+#ifndef LVGL_DRAW_BUF_MODE
+#if ESP_PANEL_LCD_BUS_TYPE == ESP_PANEL_BUS_TYPE_RGB
+#define LVGL_DRAW_BUF_MODE      LVGL_DRAW_BUF_RGB_VSYNC
+#else
+#define LVGL_DRAW_BUF_MODE      LVGL_DRAW_BUF_DOUBLE
+#endif
+#endif
+#ifndef LVGL_BUF_LINES
+#define LVGL_BUF_LINES          (20)    // Lines per partial buffer
+#endif
+#define LVGL_BUF_SIZE           (ESP_PANEL_LCD_H_RES * LVGL_BUF_LINES)
+#define LVGL_FULL_BUF_SIZE      (ESP_PANEL_LCD_H_RES * ESP_PANEL_LCD_V_RES)
 
 // Static instance
 PanelManager* PanelManager::_instance = nullptr;
@@ -34,7 +59,32 @@ PanelManager::PanelManager()
     : _panel(nullptr),
       _expander(nullptr),
       _lvgl_mux(nullptr),
-      _initialized(false)
+      _initialized(false),
+      _lvglTask(nullptr),
+      _beforeRender(nullptr),
+      _flushTask(nullptr),
+      _flushDisp(nullptr),
+      _flushPixels(nullptr),
+      _touchTask(nullptr),
+      _indev(nullptr),
+      _touchPressed(false),
+      _touchX(0),
+      _touchY(0),
+      _touchChanged(false),
+      _touchMux(portMUX_INITIALIZER_UNLOCKED),
+      _vsyncMode(false),
+      _vsync(nullptr),
+      _dirtyCount(0),
+      _strategy("none"),
+      _frames(0),
+      _lastFrameMs(0),
+      _maxFrameMs(0),
+      _totalFrameMs(0),
+      _lastPixels(0),
+      _flushes(0),
+      _maxFlushUs(0),
+      _totalFlushUs(0),
+      _statsMux(portMUX_INITIALIZER_UNLOCKED)
 {
     _instance = this;
 }
@@ -71,13 +121,21 @@ bool PanelManager::begin()
         return false;
     }
     
+#if ESP_PANEL_USE_LCD_TOUCH
+    // Touch controller is out of reset now; start the interrupt path
+    if (!initTouch()) {
+        Serial.println("[Panel] Touch initialization failed");
+        return false;
+    }
+#endif
+    
     // Initialize UI
     lock();
     ui_init();
     unlock();
     
     // Create LVGL task AFTER everything is initialized
-    xTaskCreate(lvgl_port_task, "lvgl", LVGL_TASK_STACK_SIZE, NULL, LVGL_TASK_PRIORITY, NULL);
+    xTaskCreate(lvgl_port_task, "lvgl", LVGL_TASK_STACK_SIZE, NULL, LVGL_TASK_PRIORITY, &_lvglTask);
     Serial.println("[Panel] ✓ LVGL task created");
     
     _initialized = true;
@@ -99,12 +157,10 @@ bool PanelManager::initLVGL()
     
     // Initialize LVGL buffers
     static lv_disp_draw_buf_t draw_buf;
-    uint8_t *buf = (uint8_t *)heap_caps_calloc(1, LVGL_BUF_SIZE * sizeof(lv_color_t), MALLOC_CAP_INTERNAL);
-    if (!buf) {
+    if (!allocDrawBuffers(&draw_buf)) {
         Serial.println("[Panel] Failed to allocate LVGL buffer");
         return false;
     }
-    lv_disp_draw_buf_init(&draw_buf, buf, NULL, LVGL_BUF_SIZE);
     
     // Initialize the display device
     static lv_disp_drv_t disp_drv;
@@ -112,16 +168,33 @@ bool PanelManager::initLVGL()
     disp_drv.hor_res = ESP_PANEL_LCD_H_RES;
     disp_drv.ver_res = ESP_PANEL_LCD_V_RES;
     disp_drv.flush_cb = lvgl_port_disp_flush;
+    disp_drv.monitor_cb = lvgl_port_monitor;
     disp_drv.draw_buf = &draw_buf;
+    // Tear-free mode: LVGL keeps the whole frame and redraws only dirty areas
+    disp_drv.direct_mode = _vsyncMode;
     lv_disp_drv_register(&disp_drv);
     
+#if ESP_PANEL_LCD_BUS_TYPE == ESP_PANEL_BUS_TYPE_RGB
+    if (_vsyncMode) {
+        _vsync = xSemaphoreCreateBinary();
+    }
+    
+    // The RGB copy is done by the CPU: with a second buffer, move it to a
+    // task so LVGL can render the next area meanwhile. In tear-free mode
+    // the task waits for vsync before presenting the frame.
+    if (draw_buf.buf2 || _vsyncMode) {
+        xTaskCreatePinnedToCore(lvgl_port_flush_task, "lvgl_flush", LVGL_FLUSH_TASK_STACK, NULL,
+                                LVGL_TASK_PRIORITY + 1, &_flushTask, LVGL_FLUSH_TASK_CORE);
+    }
+#endif
+    
 #if ESP_PANEL_USE_LCD_TOUCH
     // Initialize the input device
     static lv_indev_drv_t indev_drv;
     lv_indev_drv_init(&indev_drv);
     indev_drv.type = LV_INDEV_TYPE_POINTER;
     indev_drv.read_cb = lvgl_port_tp_read;
-    lv_indev_drv_register(&indev_drv);
+    _indev = lv_indev_drv_register(&indev_drv);
 #endif
     
     // Create LVGL mutex
@@ -137,6 +210,50 @@ bool PanelManager::initLVGL()
     return true;
 }
 
+bool PanelManager::allocDrawBuffers(lv_disp_draw_buf_t *draw_buf)
+{
+    void *buf1 = nullptr;
+    void *buf2 = nullptr;
+    uint32_t size = LVGL_BUF_SIZE;
+    
+#if (LVGL_DRAW_BUF_MODE == LVGL_DRAW_BUF_RGB_VSYNC) && (ESP_PANEL_LCD_BUS_TYPE == ESP_PANEL_BUS_TYPE_RGB)
+    // Back buffer; the panel's own PSRAM frame buffer is the front buffer
+    size = LVGL_FULL_BUF_SIZE;
+    buf1 = heap_caps_malloc(size * sizeof(lv_color_t), MALLOC_CAP_SPIRAM);
+    _vsyncMode = (buf1 != nullptr);
+    _strategy = "rgb-vsync";
+#elif LVGL_DRAW_BUF_MODE == LVGL_DRAW_BUF_FULL_PSRAM
+    size = LVGL_FULL_BUF_SIZE;
+    buf1 = heap_caps_malloc(size * sizeof(lv_color_t), MALLOC_CAP_SPIRAM);
+    buf2 = heap_caps_malloc(size * sizeof(lv_color_t), MALLOC_CAP_SPIRAM);
+    _strategy = "full-psram";
+#elif LVGL_DRAW_BUF_MODE == LVGL_DRAW_BUF_DOUBLE
+    buf1 = heap_caps_malloc(size * sizeof(lv_color_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
+    buf2 = heap_caps_malloc(size * sizeof(lv_color_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
+    _strategy = "double";
+#endif
+    
+    // Fall back to the single partial buffer when the strategy does not fit
+    if (!buf1 || (!buf2 && !_vsyncMode)) {
+#if LVGL_DRAW_BUF_MODE != LVGL_DRAW_BUF_SINGLE
+        Serial.printf("[Panel] No memory for '%s' draw buffers, using single\n", _strategy);
+#endif
+        heap_caps_free(buf1);
+        heap_caps_free(buf2);
+        buf2 = nullptr;
+        size = LVGL_BUF_SIZE;
+        buf1 = heap_caps_malloc(size * sizeof(lv_color_t), MALLOC_CAP_INTERNAL);
+        _strategy = "single";
+        if (!buf1) {
+            return false;
+        }
+    }
+    
+    lv_disp_draw_buf_init(draw_buf, buf1, buf2, size);
+    Serial.printf("[Panel] Draw buffers: %s, %lu px each\n", _strategy, (unsigned long)size);
+    return true;
+}
+
 bool PanelManager::initPanel()
 {
     Serial.println("[Panel] Initializing display panel...");
@@ -152,6 +269,11 @@ bool PanelManager::initPanel()
     // Register flush ready callback for DMA
     static lv_disp_drv_t* disp_drv_ptr = lv_disp_get_default()->driver;
     _panel->getLcd()->setCallback(notify_lvgl_flush_ready, disp_drv_ptr);
+#else
+    // Frame transfer done (vsync) paces the tear-free presentation
+    if (_vsyncMode) {
+        _panel->getLcd()->setCallback(notify_lvgl_vsync, NULL);
+    }
 #endif
     
     Serial.println("[Panel] ✓ Display panel initialized");
@@ -183,6 +305,24 @@ bool PanelManager::initIOExpander()
     return true;
 }
 
+#if ESP_PANEL_USE_LCD_TOUCH
+bool PanelManager::initTouch()
+{
+    Serial.println("[Panel] Initializing touch interrupt...");
+    
+    xTaskCreate(touch_task, "touch", TOUCH_TASK_STACK_SIZE, NULL, TOUCH_TASK_PRIORITY, &_touchTask);
+    if (!_touchTask) {
+        return false;
+    }
+    
+    pinMode(TP_INT, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(TP_INT), touch_isr, FALLING);
+    
+    Serial.println("[Panel] ✓ Touch interrupt initialized");
+    return true;
+}
+#endif
+
 void PanelManager::lock(int timeout_ms)
 {
     lvgl_port_lock(timeout_ms);
@@ -193,20 +333,190 @@ void PanelManager::unlock()
     lvgl_port_unlock();
 }
 
+void PanelManager::wake()
+{
+    lvgl_port_wake();
+}
+
+// ============================================================================
+// FRAME TIMING
+// ============================================================================
+
+FrameStats PanelManager::getFrameStats() const
+{
+    FrameStats stats;
+    portENTER_CRITICAL(&_statsMux);
+    stats.strategy = _strategy;
+    stats.frames = _frames;
+    stats.lastMs = _lastFrameMs;
+    stats.maxMs = _maxFrameMs;
+    stats.avgMs = _frames ? (uint32_t)(_totalFrameMs / _frames) : 0;
+    stats.lastPixels = _lastPixels;
+    stats.flushes = _flushes;
+    stats.maxFlushUs = _maxFlushUs;
+    stats.avgFlushUs = _flushes ? (uint32_t)(_totalFlushUs / _flushes) : 0;
+    portEXIT_CRITICAL(&_statsMux);
+    return stats;
+}
+
+void PanelManager::resetFrameStats()
+{
+    portENTER_CRITICAL(&_statsMux);
+    _frames = 0;
+    _lastFrameMs = 0;
+    _maxFrameMs = 0;
+    _totalFrameMs = 0;
+    _flushes = 0;
+    _maxFlushUs = 0;
+    _totalFlushUs = 0;
+    portEXIT_CRITICAL(&_statsMux);
+}
+
+void PanelManager::lvgl_port_monitor(lv_disp_drv_t *disp, uint32_t time_ms, uint32_t px)
+{
+    // Called by LVGL after every refresh (render + flush)
+    if (!_instance) {
+        return;
+    }
+    
+    portENTER_CRITICAL(&_instance->_statsMux);
+    _instance->_frames++;
+    _instance->_lastFrameMs = time_ms;
+    _instance->_totalFrameMs += time_ms;
+    _instance->_lastPixels = px;
+    if (time_ms > _instance->_maxFrameMs) {
+        _instance->_maxFrameMs = time_ms;
+    }
+    portEXIT_CRITICAL(&_instance->_statsMux);
+}
+
+void PanelManager::drawArea(const lv_area_t *area, lv_color_t *color_p)
+{
+    int64_t start = esp_timer_get_time();
+    _panel->getLcd()->drawBitmap(area->x1, area->y1, area->x2 + 1, area->y2 + 1, color_p);
+    recordFlush((uint32_t)(esp_timer_get_time() - start));
+}
+
+void PanelManager::recordFlush(uint32_t elapsed)
+{
+    portENTER_CRITICAL(&_statsMux);
+    _flushes++;
+    _totalFlushUs += elapsed;
+    if (elapsed > _maxFlushUs) {
+        _maxFlushUs = elapsed;
+    }
+    portEXIT_CRITICAL(&_statsMux);
+}
+
+// ============================================================================
+// TEAR-FREE PRESENTATION
+// ============================================================================
+
+void PanelManager::addDirtyArea(const lv_area_t *area)
+{
+    if (_dirtyCount < MAX_DIRTY_AREAS) {
+        _dirty[_dirtyCount++] = *area;
+        return;
+    }
+    
+    // Out of slots: grow the last area to cover this one too
+    lv_area_t joined;
+    _lv_area_join(&joined, &_dirty[MAX_DIRTY_AREAS - 1], area);
+    _dirty[MAX_DIRTY_AREAS - 1] = joined;
+}
+
+void PanelManager::present(lv_color_t *frame)
+{
+    // Start right after a frame was sent out: the scan restarts at the top
+    // and the row-ordered copy below stays ahead of it, so no frame shows
+    // a half-updated area
+    xSemaphoreTake(_vsync, 0);
+    xSemaphoreTake(_vsync, pdMS_TO_TICKS(LVGL_VSYNC_TIMEOUT_MS));
+    
+    int64_t start = esp_timer_get_time();
+    lv_coord_t top = ESP_PANEL_LCD_V_RES;
+    lv_coord_t bottom = -1;
+    for (uint8_t i = 0; i < _dirtyCount; i++) {
+        top = LV_MIN(top, _dirty[i].y1);
+        bottom = LV_MAX(bottom, _dirty[i].y2);
+    }
+    
+    for (lv_coord_t y = top; y <= bottom; y++) {
+        for (uint8_t i = 0; i < _dirtyCount; i++) {
+            const lv_area_t &area = _dirty[i];
+            if (y < area.y1 || y > area.y2) {
+                continue;
+            }
+            _panel->getLcd()->drawBitmap(area.x1, y, area.x2 + 1, y + 1,
+                                         frame + (int32_t)y * ESP_PANEL_LCD_H_RES + area.x1);
+        }
+    }
+    
+    _dirtyCount = 0;
+    recordFlush((uint32_t)(esp_timer_get_time() - start));
+}
+
+bool PanelManager::notify_lvgl_vsync(void *user_ctx)
+{
+    BaseType_t woken = pdFALSE;
+    if (_instance && _instance->_vsync) {
+        xSemaphoreGiveFromISR(_instance->_vsync, &woken);
+    }
+    return woken == pdTRUE;
+}
+
 // Static callbacks
 #if ESP_PANEL_LCD_BUS_TYPE == ESP_PANEL_BUS_TYPE_RGB
 void PanelManager::lvgl_port_disp_flush(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color_p)
 {
-    if (_instance && _instance->_panel) {
-        _instance->_panel->getLcd()->drawBitmap(area->x1, area->y1, area->x2 + 1, area->y2 + 1, color_p);
-        lv_disp_flush_ready(disp);
+    if (!_instance || !_instance->_panel) {
+        return;
+    }
+    
+    if (_instance->_vsyncMode) {
+        // Direct mode: color_p is the whole frame; collect the areas of this
+        // refresh and present them together after the next vsync
+        _instance->addDirtyArea(area);
+        if (!lv_disp_flush_is_last(disp)) {
+            lv_disp_flush_ready(disp);
+            return;
+        }
+        _instance->_flushDisp = disp;
+        _instance->_flushPixels = color_p;
+        xTaskNotifyGive(_instance->_flushTask);
+        return;
+    }
+    
+    if (_instance->_flushTask) {
+        // LVGL does not flush again before lv_disp_flush_ready, one slot is enough
+        _instance->_flushDisp = disp;
+        _instance->_flushArea = *area;
+        _instance->_flushPixels = color_p;
+        xTaskNotifyGive(_instance->_flushTask);
+        return;
+    }
+    
+    _instance->drawArea(area, color_p);
+    lv_disp_flush_ready(disp);
+}
+
+void PanelManager::lvgl_port_flush_task(void *arg)
+{
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (_instance->_vsyncMode) {
+            _instance->present(_instance->_flushPixels);
+        } else {
+            _instance->drawArea(&_instance->_flushArea, _instance->_flushPixels);
+        }
+        lv_disp_flush_ready(_instance->_flushDisp);
     }
 }
 #else
 void PanelManager::lvgl_port_disp_flush(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color_p)
 {
     if (_instance && _instance->_panel) {
-        _instance->_panel->getLcd()->drawBitmap(area->x1, area->y1, area->x2 + 1, area->y2 + 1, color_p);
+        _instance->drawArea(area, color_p);
     }
 }
 
@@ -221,27 +531,78 @@ bool PanelManager::notify_lvgl_flush_ready(void *user_ctx)
 #if ESP_PANEL_USE_LCD_TOUCH
 void PanelManager::lvgl_port_tp_read(lv_indev_drv_t * indev, lv_indev_data_t * data)
 {
-    if (!_instance || !_instance->_panel) {
+    if (!_instance) {
         data->state = LV_INDEV_STATE_REL;
         return;
     }
     
-    _instance->_panel->getLcdTouch()->readData();
+    // Latest point cached by touch_task; no bus traffic here
+    portENTER_CRITICAL(&_instance->_touchMux);
+    bool pressed = _instance->_touchPressed;
+    data->point.x = _instance->_touchX;
+    data->point.y = _instance->_touchY;
+    portEXIT_CRITICAL(&_instance->_touchMux);
     
-    bool touched = _instance->_panel->getLcdTouch()->getTouchState();
-    if(!touched) {
-        data->state = LV_INDEV_STATE_REL;
-    } else {
-        TouchPoint point = _instance->_panel->getLcdTouch()->getPoint();
+    data->state = pressed ? LV_INDEV_STATE_PR : LV_INDEV_STATE_REL;
+}
+
+void IRAM_ATTR PanelManager::touch_isr(void)
+{
+    BaseType_t need_yield = pdFALSE;
+    if (_instance && _instance->_touchTask) {
+        vTaskNotifyGiveFromISR(_instance->_touchTask, &need_yield);
+    }
+    if (need_yield) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+void PanelManager::touch_task(void *arg)
+{
+    Serial.println("[Panel] Starting touch task");
+    
+    ESP_PanelLcdTouch *touch = _instance->_panel->getLcdTouch();
+    bool pressed = false;
+    bool swallow = false;
+    
+    while (1) {
+        // Idle until the controller raises INT; while a finger is down,
+        // also wake periodically so a missed release edge is still seen
+        ulTaskNotifyTake(pdTRUE, pressed ? pdMS_TO_TICKS(TOUCH_PRESSED_POLL_MS) : portMAX_DELAY);
+        
+        touch->readData();
+        bool touched = touch->getTouchState();
+        TouchPoint point;
+        if (touched) {
+            point = touch->getPoint();
+            
+            // Keeps the display awake; a touch that wakes it is not passed on
+            bool consumed = SleepManager::getInstance().onTouch();
+            if (!pressed) {
+                swallow = consumed;
+            }
+        }
         
-        data->state = LV_INDEV_STATE_PR;
-        data->point.x = point.x;
-        data->point.y = point.y;
+        bool report = touched && !swallow;
+        portENTER_CRITICAL(&_instance->_touchMux);
+        bool changed = report != _instance->_touchPressed;
+        _instance->_touchPressed = report;
+        if (report) {
+            _instance->_touchX = point.x;
+            _instance->_touchY = point.y;
+        }
+        portEXIT_CRITICAL(&_instance->_touchMux);
         
-        Serial.printf("Touch point: x %d, y %d\\n", point.x, point.y);
+        // Let LVGL read the new state now instead of at its next poll
+        if (changed) {
+            _instance->_touchChanged = true;
+            lvgl_port_wake();
+        }
         
-        // Reset sleep timer on touch
-        SleepManager::getInstance().resetTimer();
+        if (!touched) {
+            swallow = false;
+        }
+        pressed = touched;
     }
 }
 #endif
@@ -261,6 +622,13 @@ void PanelManager::lvgl_port_unlock(void)
     }
 }
 
+void PanelManager::lvgl_port_wake(void)
+{
+    if (_instance && _instance->_lvglTask) {
+        xTaskNotifyGive(_instance->_lvglTask);
+    }
+}
+
 void PanelManager::lvgl_port_task(void *arg)
 {
     Serial.println("[Panel] Starting LVGL task");
@@ -274,6 +642,13 @@ void PanelManager::lvgl_port_task(void *arg)
         // }
         
         lvgl_port_lock(-1);
+        if (_instance && _instance->_touchChanged && _instance->_indev) {
+            _instance->_touchChanged = false;
+            lv_timer_ready(_instance->_indev->driver->read_timer);
+        }
+        if (_instance && _instance->_beforeRender) {
+            _instance->_beforeRender();
+        }
         task_delay_ms = lv_timer_handler();
         lvgl_port_unlock();
         
@@ -282,7 +657,8 @@ void PanelManager::lvgl_port_task(void *arg)
         } else if (task_delay_ms < LVGL_TASK_MIN_DELAY_MS) {
             task_delay_ms = LVGL_TASK_MIN_DELAY_MS;
         }
-        vTaskDelay(pdMS_TO_TICKS(task_delay_ms));
+        // Sleep until the next LVGL timer, or until new UI state is posted
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(task_delay_ms));
         loop_count++;
     }
 }
@@ -6,6 +6,29 @@
 #include <ESP_Panel_Library.h>
 #include <ESP_IOExpander_Library.h>
 
+/**
+ * @brief LVGL draw buffer strategies (select with LVGL_DRAW_BUF_MODE)
+ */
+#define LVGL_DRAW_BUF_SINGLE        0   // One partial buffer in internal RAM, render and flush in turn
+#define LVGL_DRAW_BUF_DOUBLE        1   // Two partial buffers in internal DMA RAM, flush overlaps rendering
+#define LVGL_DRAW_BUF_FULL_PSRAM    2   // Two full-frame buffers in PSRAM
+#define LVGL_DRAW_BUF_RGB_VSYNC     3   // RGB only: full-frame PSRAM back buffer, presented after vsync (tear-free)
+
+/**
+ * @brief Frame timing counters of the display
+ */
+struct FrameStats {
+    const char* strategy;   // Draw buffer strategy in use
+    uint32_t frames;        // Refreshes since the last reset
+    uint32_t lastMs;        // Render + flush time of the last refresh
+    uint32_t maxMs;
+    uint32_t avgMs;
+    uint32_t lastPixels;    // Pixels redrawn by the last refresh
+    uint32_t flushes;       // Areas sent to the panel
+    uint32_t maxFlushUs;
+    uint32_t avgFlushUs;
+};
+
 /**
  * @brief Panel Manager - Handles all LVGL and display panel initialization
  * 
@@ -54,6 +77,33 @@ public:
      * @brief Get unlock function pointer (for callbacks)
      */
     void (*getUnlockFunction())() { return lvgl_port_unlock; }
+    
+    /**
+     * @brief Register a callback run by the LVGL task before each render
+     * 
+     * Runs with the LVGL mutex held; used to apply queued UI state.
+     */
+    void onBeforeRender(void (*callback)(void)) { _beforeRender = callback; }
+    
+    /**
+     * @brief Wake the LVGL task early (safe from any task)
+     */
+    void wake();
+    
+    /**
+     * @brief Get wake function pointer (for callbacks)
+     */
+    void (*getWakeFunction())() { return lvgl_port_wake; }
+    
+    /**
+     * @brief Get a copy of the frame timing counters
+     */
+    FrameStats getFrameStats() const;
+    
+    /**
+     * @brief Reset the frame timing counters
+     */
+    void resetFrameStats();
 
 private:
     PanelManager();
@@ -68,6 +118,45 @@ private:
     SemaphoreHandle_t _lvgl_mux;
     bool _initialized;
     
+    // LVGL task and the work it runs before rendering
+    TaskHandle_t _lvglTask;
+    void (*_beforeRender)(void);
+    
+    // Asynchronous flush (RGB bus with two draw buffers)
+    TaskHandle_t _flushTask;
+    lv_disp_drv_t* _flushDisp;
+    lv_area_t _flushArea;
+    lv_color_t* _flushPixels;
+    
+    // Interrupt-driven touch: a task reads the controller on INT and
+    // caches the latest point for the LVGL input device
+    TaskHandle_t _touchTask;
+    lv_indev_t* _indev;
+    bool _touchPressed;
+    uint16_t _touchX;
+    uint16_t _touchY;
+    volatile bool _touchChanged;
+    portMUX_TYPE _touchMux;
+    
+    // Tear-free presentation (LVGL_DRAW_BUF_RGB_VSYNC)
+    static const uint8_t MAX_DIRTY_AREAS = 16;
+    bool _vsyncMode;
+    SemaphoreHandle_t _vsync;
+    lv_area_t _dirty[MAX_DIRTY_AREAS];
+    uint8_t _dirtyCount;
+    
+    // Frame timing
+    const char* _strategy;
+    uint32_t _frames;
+    uint32_t _lastFrameMs;
+    uint32_t _maxFrameMs;
+    uint64_t _totalFrameMs;
+    uint32_t _lastPixels;
+    uint32_t _flushes;
+    uint32_t _maxFlushUs;
+    uint64_t _totalFlushUs;
+    mutable portMUX_TYPE _statsMux;
+    
     // LVGL callbacks (static for C API)
     static void lvgl_port_disp_flush(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color_p);
     static bool notify_lvgl_flush_ready(void *user_ctx);
@@ -75,14 +164,27 @@ private:
     static void lvgl_port_lock(int timeout_ms);
     static void lvgl_port_unlock(void);
     static void lvgl_port_task(void *arg);
+    static void lvgl_port_wake(void);
+    static void lvgl_port_flush_task(void *arg);
+    static void lvgl_port_monitor(lv_disp_drv_t *disp, uint32_t time_ms, uint32_t px);
+    static bool notify_lvgl_vsync(void *user_ctx);
+    static void touch_isr(void);
+    static void touch_task(void *arg);
+    
+    void drawArea(const lv_area_t *area, lv_color_t *color_p);
+    void addDirtyArea(const lv_area_t *area);
+    void present(lv_color_t *frame);
+    void recordFlush(uint32_t elapsedUs);
     
     // Singleton instance
     static PanelManager* _instance;
     
     // Helper methods
     bool initLVGL();
+    bool allocDrawBuffers(lv_disp_draw_buf_t *draw_buf);
     bool initPanel();
     bool initIOExpander();
+    bool initTouch();
 };
 
 #endif // PANEL_MANAGER_H
@@ -12,7 +12,8 @@ SleepManager::SleepManager()
       _lastActivityTime(0),
       _sleepStartTime(0),
       _sleeping(false),
-      _initialized(false) {
+      _initialized(false),
+      _mutex(nullptr) {
 }
 
 SleepManager::~SleepManager() {
@@ -24,6 +25,9 @@ void SleepManager::init(ESP_Panel* panel, ESP_IOExpander* expander) {
         return;
     }
     
+    if (!_mutex) {
+        _mutex = xSemaphoreCreateMutex();
+    }
     _panel = panel;
     _expander = expander;
     _lastActivityTime = millis();
@@ -33,42 +37,30 @@ void SleepManager::init(ESP_Panel* panel, ESP_IOExpander* expander) {
     Serial.printf("[Sleep] Initialized (timeout: %lu ms)\n", SLEEP_TIMEOUT_MS);
 }
 
+void SleepManager::lock() {
+    if (_mutex) {
+        xSemaphoreTake(_mutex, portMAX_DELAY);
+    }
+}
+
+void SleepManager::unlock() {
+    if (_mutex) {
+        xSemaphoreGive(_mutex);
+    }
+}
+
 void SleepManager::update() {
     if (!_initialized) {
         return;
     }
     
-    unsigned long now = millis();
-    
-    if (_sleeping) {
-        // COOL DOWN PERIOD: Ignore all touches for 1 second after sleeping
-        // This prevents immediate wake-up due to backlight power noise
-        if (millis() - _sleepStartTime < 1000) {
-            return;
-        }
-        
-        // Check for touch (polling)
-        _panel->getLcdTouch()->readData();
-        if (_panel->getLcdTouch()->getTouchState()) {
-            // Double check to confirm it's a real touch (debounce)
-            delay(50); // Debounce time
-            _panel->getLcdTouch()->readData();
-            
-            if (_panel->getLcdTouch()->getTouchState()) {
-                TouchPoint p = _panel->getLcdTouch()->getPoint();
-                Serial.printf("[Sleep] Wake-up touch detected at %d, %d\n", p.x, p.y);
-                wake();
-            }
-        }
-        return;
-    }
-    
-    unsigned long inactiveTime = now - _lastActivityTime;
-    
-    // Check if we should sleep
-    if (inactiveTime >= SLEEP_TIMEOUT_MS) {
-        sleep();
+    // Waking is driven by onTouch(); re-check under the lock, a touch may
+    // have just counted as activity
+    lock();
+    if (!_sleeping && millis() - _lastActivityTime >= SLEEP_TIMEOUT_MS) {
+        enterSleep();
     }
+    unlock();
 }
 
 void SleepManager::resetTimer() {
@@ -76,16 +68,58 @@ void SleepManager::resetTimer() {
         return;
     }
     
+    lock();
     _lastActivityTime = millis();
     
     // Wake up if sleeping
     if (_sleeping) {
-        wake();
+        exitSleep();
+    }
+    unlock();
+}
+
+bool SleepManager::onTouch() {
+    if (!_initialized) {
+        return false;
     }
+    
+    bool consumed = true;
+    lock();
+    if (!_sleeping) {
+        _lastActivityTime = millis();
+        consumed = false;
+    } else if (millis() - _sleepStartTime >= WAKE_COOLDOWN_MS) {
+        // COOL DOWN PERIOD: touches right after sleeping are ignored;
+        // this prevents immediate wake-up due to backlight power noise
+        Serial.println("[Sleep] Wake-up touch detected");
+        exitSleep();
+    }
+    unlock();
+    return consumed;
 }
 
 void SleepManager::sleep() {
-    if (!_initialized || _sleeping) {
+    if (!_initialized) {
+        return;
+    }
+    
+    lock();
+    enterSleep();
+    unlock();
+}
+
+void SleepManager::wake() {
+    if (!_initialized) {
+        return;
+    }
+    
+    lock();
+    exitSleep();
+    unlock();
+}
+
+void SleepManager::enterSleep() {
+    if (_sleeping) {
         return;
     }
     
@@ -98,8 +132,8 @@ void SleepManager::sleep() {
     _sleepStartTime = millis(); // Record sleep start time
 }
 
-void SleepManager::wake() {
-    if (!_initialized || !_sleeping) {
+void SleepManager::exitSleep() {
+    if (!_sleeping) {
         return;
     }
     
@@ -9,7 +9,11 @@
 /**
  * @brief Sleep Manager for automatic display sleep mode
  * 
- * Manages display backlight based on user activity
+ * Manages display backlight based on user activity. Touches arrive
+ * from the touch interrupt task, so waking needs no polling.
+ * 
+ * The touch task (onTouch) and the loop task (update) both switch the
+ * state; every transition and its backlight write run under one mutex.
  */
 class SleepManager {
 public:
@@ -36,6 +40,15 @@ public:
      */
     void resetTimer();
     
+    /**
+     * @brief Report a touch (called by the touch task on every read with a point)
+     * 
+     * Counts as activity while awake, and wakes the display while asleep.
+     * @return true if the touch was used to wake the display (or ignored
+     *         during the cool-down) and should not reach the UI
+     */
+    bool onTouch();
+    
     /**
      * @brief Force sleep mode
      */
@@ -63,10 +76,25 @@ private:
     ESP_IOExpander* _expander;
     unsigned long _lastActivityTime;
     unsigned long _sleepStartTime;
-    bool _sleeping;
+    volatile bool _sleeping;
     bool _initialized;
+    SemaphoreHandle_t _mutex;
+    
+    /**
+     * @brief Turn the backlight off (caller holds the mutex)
+     */
+    void enterSleep();
+    
+    /**
+     * @brief Turn the backlight on (caller holds the mutex)
+     */
+    void exitSleep();
+    
+    void lock();
+    void unlock();
     
     static const unsigned long SLEEP_TIMEOUT_MS = 30000; // 60 seconds
+    static const unsigned long WAKE_COOLDOWN_MS = 1000; // Ignore touches right after sleeping
     static const int PIN_LCD_BL = 2; // Backlight pin on IO Expander
 };
 
@@ -1,109 +1,245 @@
 #include "UIStateManager.h"
 #include "espnow_config.h"
 
+using namespace VanSight;
+
 UIStateManager& UIStateManager::getInstance() {
     static UIStateManager instance;
     return instance;
 }
 
 UIStateManager::UIStateManager()
-    : _lockFunc(nullptr),
-      _unlockFunc(nullptr),
-      _initialized(false) {
+    : _wakeFunc(nullptr),
+      _queue(nullptr),
+      _initialized(false),
+      _connectedShown(-1),
+      _statsMux(portMUX_INITIALIZER_UNLOCKED) {
+    memset(_relayShown, -1, sizeof(_relayShown));
+    memset(_sensorShown, -1, sizeof(_sensorShown));
+    memset(&_stats, 0, sizeof(_stats));
 }
 
 UIStateManager::~UIStateManager() {
+    if (_queue) vQueueDelete(_queue);
 }
 
-void UIStateManager::init(void (*lockFunc)(int), void (*unlockFunc)(void)) {
-    _lockFunc = lockFunc;
-    _unlockFunc = unlockFunc;
+void UIStateManager::init(void (*wakeFunc)(void)) {
+    _wakeFunc = wakeFunc;
+    _queue = xQueueCreate(UI_STATE_QUEUE_LENGTH, sizeof(UIStateUpdate));
+    if (!_queue) {
+        Serial.println("[UI] Failed to create state queue");
+        return;
+    }
     _initialized = true;
     Serial.println("[UI] State Manager initialized");
 }
 
-void UIStateManager::updateButtonState(lv_obj_t* buttonObj, bool isActive) {
-    if (!_initialized || !buttonObj) {
-        return;
+// ============================================================================
+// POSTING (any task)
+// ============================================================================
+
+bool UIStateManager::post(const UIStateUpdate& update) {
+    if (!_initialized) {
+        return false;
     }
     
-    if (_lockFunc) _lockFunc(-1);
+    if (xQueueSend(_queue, &update, 0) != pdTRUE) {
+        portENTER_CRITICAL(&_statsMux);
+        _stats.dropped++;
+        portEXIT_CRITICAL(&_statsMux);
+        Serial.println("[UI] State queue full, update dropped");
+        return false;
+    }
     
-    lv_color_t color = isActive ? COLOR_BUTTON_ACTIVE : COLOR_BUTTON_INACTIVE;
-    lv_obj_set_style_bg_color(buttonObj, color, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(buttonObj, 255, LV_PART_MAIN | LV_STATE_DEFAULT); // Ensure opacity is set
+    if (_wakeFunc) _wakeFunc();
+    return true;
+}
+
+bool UIStateManager::postStatus(const AllStatusData& data) {
+    UIStateUpdate update = {};
+    update.fields = UI_FIELD_RELAYS | UI_FIELD_SENSORS;
+    update.relayMask = (RelayMask)((1u << MAX_RELAYS) - 1);
+    for (int i = 0; i < MAX_RELAYS; i++) {
+        if (data.relayStates[i]) update.relayState |= (1u << i);
+    }
+    for (int i = 0; i < MAX_SENSORS; i++) {
+        update.sensorLevels[i] = constrain(data.sensorLevels[i], 0, 100);
+    }
+    update.traces = traceBit(CMD_ALL_STATUS);
+    return post(update);
+}
+
+bool UIStateManager::postRelay(uint8_t relayNum, bool state, CommandType trace) {
+    if (relayNum < 1 || relayNum > MAX_RELAYS) {
+        return false;
+    }
     
-    if (_unlockFunc) _unlockFunc();
+    RelayMask bit = (RelayMask)(1u << (relayNum - 1));
+    return postRelays(bit, state ? bit : 0, traceBit(trace));
 }
 
-void UIStateManager::updateSensorLevel(lv_obj_t* barObj, lv_obj_t* labelObj, int level) {
-    if (!_initialized || !barObj || !labelObj) {
+bool UIStateManager::postRelays(RelayMask changed, RelayMask state, uint32_t traces) {
+    UIStateUpdate update = {};
+    update.fields = UI_FIELD_RELAYS;
+    update.relayMask = changed;
+    update.relayState = state & changed;
+    update.traces = traces;
+    return post(update);
+}
+
+bool UIStateManager::postConnection(bool connected) {
+    UIStateUpdate update = {};
+    update.fields = UI_FIELD_CONNECTION;
+    update.connected = connected;
+    return post(update);
+}
+
+// ============================================================================
+// APPLYING (LVGL task)
+// ============================================================================
+
+void UIStateManager::applyPending() {
+    if (!_initialized) {
         return;
     }
     
-    // Clamp level to 0-100
-    level = constrain(level, 0, 100);
+    // Fold every queued message into one state, later messages win
+    UIStateUpdate update;
+    uint8_t fields = 0;
+    RelayMask relayMask = 0;
+    RelayMask relayState = 0;
+    int8_t sensorLevels[MAX_SENSORS] = {0};
+    bool connected = false;
+    uint32_t traces = 0;
+    uint16_t count = 0;
     
-    if (_lockFunc) _lockFunc(-1);
+    while (xQueueReceive(_queue, &update, 0) == pdTRUE) {
+        fields |= update.fields;
+        if (update.fields & UI_FIELD_RELAYS) {
+            relayState = (relayState & ~update.relayMask) | (update.relayState & update.relayMask);
+            relayMask |= update.relayMask;
+        }
+        if (update.fields & UI_FIELD_SENSORS) {
+            memcpy(sensorLevels, update.sensorLevels, sizeof(sensorLevels));
+        }
+        if (update.fields & UI_FIELD_CONNECTION) {
+            connected = update.connected;
+        }
+        traces |= update.traces;
+        count++;
+    }
     
-    // Update bar value
-    lv_bar_set_value(barObj, level, LV_ANIM_ON);
+    if (count == 0) {
+        return;
+    }
     
-    // Update label text
-    char text[8];
-    snprintf(text, sizeof(text), "%d%%", level);
-    lv_label_set_text(labelObj, text);
+    // Apply in one pass; the caller already holds the LVGL mutex.
+    // Widgets already showing the value are left alone.
+    uint32_t redraws = 0;
+    uint32_t skipped = 0;
     
-    if (_unlockFunc) _unlockFunc();
+    if (fields & UI_FIELD_RELAYS) {
+        for (int i = 0; i < BTN_COUNT; i++) {
+            uint8_t relayNum = BUTTON_TO_RELAY_MAP[i];
+            if (relayNum == 0 || relayNum > MAX_RELAYS || !(relayMask & (1u << (relayNum - 1)))) {
+                continue;
+            }
+            
+            int8_t active = (relayState >> (relayNum - 1)) & 1;
+            if (_relayShown[relayNum - 1] == active) {
+                skipped++;
+                continue;
+            }
+            updateButtonState(getButtonByRelayNum(relayNum), active);
+            _relayShown[relayNum - 1] = active;
+            redraws++;
+        }
+    }
     
-    Serial.printf("[UI] Sensor updated: %d%%\n", level);
-}
-
-void UIStateManager::updateAllRelayStates(int relayStates[]) {
-    if (!_initialized) {
-        return;
+    if (fields & UI_FIELD_SENSORS) {
+        for (int i = 0; i < MAX_SENSORS; i++) {
+            if (_sensorShown[i] == sensorLevels[i]) {
+                skipped++;
+                continue;
+            }
+            lv_obj_t* barObj;
+            lv_obj_t* labelObj;
+            getSensorObjects(SENSOR_CLEAN_WATER + i, &barObj, &labelObj);
+            updateSensorLevel(barObj, labelObj, sensorLevels[i]);
+            _sensorShown[i] = sensorLevels[i];
+            redraws++;
+        }
     }
     
-    Serial.println("[UI] Updating all relay states...");
+    if (fields & UI_FIELD_CONNECTION) {
+        if (_connectedShown == (int8_t)connected) {
+            skipped++;
+        } else {
+            updateConnectionStatus(connected);
+            _connectedShown = connected;
+            redraws++;
+        }
+    }
     
-    // Update each button based on relay state
-    for (int i = 0; i < 10; i++) {  // Relays 1-10 (excluding special buttons)
-        uint8_t relayNum = BUTTON_TO_RELAY_MAP[i];
-        if (relayNum > 0 && relayNum <= 16) {
-            updateRelayButton(relayNum, relayStates[relayNum - 1]);
+    for (int type = 0; type < 32; type++) {
+        if (traces & (1UL << type)) {
+            LatencyMetrics::getInstance().stamp((CommandType)type, STAGE_UI_APPLY);
         }
     }
+    
+    portENTER_CRITICAL(&_statsMux);
+    _stats.batches++;
+    _stats.messages += count;
+    _stats.redraws += redraws;
+    _stats.skipped += skipped;
+    portEXIT_CRITICAL(&_statsMux);
+    
+    if (redraws > 0) {
+        Serial.printf("[UI] Applied %u update(s): %lu widget(s) changed, %lu unchanged\n",
+                      count, (unsigned long)redraws, (unsigned long)skipped);
+    }
 }
 
-void UIStateManager::updateAllSensorLevels(int sensorLevels[]) {
-    if (!_initialized) {
+UIApplyStats UIStateManager::getStats() const {
+    UIApplyStats stats;
+    portENTER_CRITICAL(&_statsMux);
+    stats = _stats;
+    portEXIT_CRITICAL(&_statsMux);
+    return stats;
+}
+
+void UIStateManager::updateButtonState(lv_obj_t* buttonObj, bool isActive) {
+    if (!buttonObj) {
         return;
     }
     
-    Serial.println("[UI] Updating all sensor levels...");
-    
-    // Update each sensor bar
-    updateSensorLevel(ui_barCleanWaterLevel, ui_lblCleanWaterPercentage, sensorLevels[0]);
-    updateSensorLevel(ui_barGrayWaterLevel, ui_lblGrayWaterPercentage, sensorLevels[1]);
-    updateSensorLevel(ui_barBlackWaterLevel, ui_lblBlackWaterPercentage, sensorLevels[2]);
+    lv_color_t color = isActive ? COLOR_BUTTON_ACTIVE : COLOR_BUTTON_INACTIVE;
+    lv_obj_set_style_bg_color(buttonObj, color, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_opa(buttonObj, 255, LV_PART_MAIN | LV_STATE_DEFAULT); // Ensure opacity is set
 }
 
-void UIStateManager::updateRelayButton(uint8_t relayNum, bool state) {
-    lv_obj_t* buttonObj = getButtonByRelayNum(relayNum);
-    if (buttonObj) {
-        updateButtonState(buttonObj, state);
-        Serial.printf("[UI] Relay %d button: %s\n", relayNum, state ? "ACTIVE" : "INACTIVE");
+void UIStateManager::updateSensorLevel(lv_obj_t* barObj, lv_obj_t* labelObj, int level) {
+    if (!barObj || !labelObj) {
+        return;
     }
+    
+    // Clamp level to 0-100
+    level = constrain(level, 0, 100);
+    
+    // Update bar value
+    lv_bar_set_value(barObj, level, LV_ANIM_ON);
+    
+    // Update label text
+    char text[8];
+    snprintf(text, sizeof(text), "%d%%", level);
+    lv_label_set_text(labelObj, text);
 }
+
 void UIStateManager::updateConnectionStatus(bool connected)
 {
-    if (_lockFunc) _lockFunc(-1);
-
     lv_color_t color = connected ? COLOR_CONNECTION_ACTIVE : COLOR_CONNECTION_LOST;
     lv_obj_set_style_bg_color(ui_lblTitle, color, LV_PART_MAIN | LV_STATE_DEFAULT);
     lv_obj_set_style_bg_opa(ui_lblTitle, 255, LV_PART_MAIN | LV_STATE_DEFAULT); // Ensure opacity is set
-
-    if (_unlockFunc) _unlockFunc();
 }
 
 lv_obj_t* UIStateManager::getButtonByRelayNum(uint8_t relayNum) {
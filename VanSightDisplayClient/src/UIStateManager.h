@@ -4,11 +4,54 @@
 #include <Arduino.h>
 #include <lvgl.h>
 #include <ui.h>
+#include <VanSightLib.h>
+
+/**
+ * @brief Fields carried by a UIStateUpdate
+ */
+enum UIStateField {
+    UI_FIELD_RELAYS     = 0x01,
+    UI_FIELD_SENSORS    = 0x02,
+    UI_FIELD_CONNECTION = 0x04
+};
+
+/**
+ * @brief One immutable UI state message
+ *
+ * Built on the sender's task and copied into the UI queue; only the
+ * fields flagged in fields are applied.
+ */
+struct UIStateUpdate {
+    uint8_t fields;                             // UIStateField flags
+    VanSight::RelayMask relayMask;              // Relays carried (bit 0 = relay 1)
+    VanSight::RelayMask relayState;             // States of the carried relays
+    int8_t sensorLevels[VanSight::MAX_SENSORS]; // Level percentages (0-100)
+    bool connected;
+    uint32_t traces;                            // Command types stamped STAGE_UI_APPLY when applied (bit = CommandType)
+};
+
+/**
+ * @brief Counters of the UI apply pass
+ */
+struct UIApplyStats {
+    uint32_t batches;       // Apply passes that found queued messages
+    uint32_t messages;      // Messages applied
+    uint32_t redraws;       // Widgets whose value changed and were touched
+    uint32_t skipped;       // Widget updates dropped as unchanged
+    uint32_t dropped;       // Messages dropped on a full queue
+};
 
 /**
  * @brief UI State Manager for thread-safe LVGL updates
  * 
- * Handles updating button colors and sensor bars based on ESP-NOW data
+ * Handles updating button colors and sensor bars based on hub data.
+ * Other tasks only post state messages to a queue; the LVGL task drains
+ * the queue before rendering and applies all pending messages in one
+ * pass, so no LVGL call ever runs outside the UI task.
+ *
+ * A small view-model remembers the value each widget currently shows;
+ * widgets whose value did not change are not touched, so LVGL does not
+ * invalidate and redraw them.
  */
 class UIStateManager {
 public:
@@ -19,45 +62,64 @@ public:
     
     /**
      * @brief Initialize UI state manager
-     * @param lockFunc LVGL lock function
-     * @param unlockFunc LVGL unlock function
+     * @param wakeFunc Wakes the LVGL task after a post (may be nullptr)
      */
-    void init(void (*lockFunc)(int), void (*unlockFunc)(void));
+    void init(void (*wakeFunc)(void));
     
     /**
-     * @brief Update button background color based on relay state
-     * @param buttonObj LVGL button object
-     * @param isActive true if relay is ON, false if OFF
+     * @brief Queue a state message for the LVGL task
+     * @return false if the queue is full (the message is dropped)
      */
-    void updateButtonState(lv_obj_t* buttonObj, bool isActive);
+    bool post(const UIStateUpdate& update);
     
     /**
-     * @brief Update sensor level bar and label
-     * @param barObj LVGL bar object
-     * @param labelObj LVGL label object for percentage
-     * @param level Level percentage (0-100)
+     * @brief Queue a full status frame (all relays and sensors)
      */
-    void updateSensorLevel(lv_obj_t* barObj, lv_obj_t* labelObj, int level);
+    bool postStatus(const VanSight::AllStatusData& data);
     
     /**
-     * @brief Update all relay button states
-     * @param relayStates Array of relay states (16 elements)
+     * @brief Queue a single relay button state
+     * @param relayNum Relay number (1-16)
+     * @param state true if ON, false if OFF
+     * @param trace Command type to stamp when applied
      */
-    void updateAllRelayStates(int relayStates[]);
+    bool postRelay(uint8_t relayNum, bool state, VanSight::CommandType trace);
     
     /**
-     * @brief Update all sensor levels
-     * @param sensorLevels Array of sensor levels (3 elements, 0-100)
+     * @brief Queue several relay button states
+     * @param changed Relays to update (bit 0 = relay 1)
+     * @param state Relay mask holding their states
+     * @param traces Command types to stamp when applied (see traceBit())
      */
-    void updateAllSensorLevels(int sensorLevels[]);
+    bool postRelays(VanSight::RelayMask changed, VanSight::RelayMask state, uint32_t traces);
     
     /**
-     * @brief Update single relay button state
-     * @param relayNum Relay number (1-16)
-     * @param state true if ON, false if OFF
+     * @brief Queue the hub connection indicator
      */
-    void updateRelayButton(uint8_t relayNum, bool state);
-    void updateConnectionStatus(bool connected);
+    bool postConnection(bool connected);
+    
+    /**
+     * @brief Drain the queue and apply it to the widgets
+     * 
+     * Call from the LVGL task with the LVGL mutex held, before
+     * lv_timer_handler().
+     */
+    void applyPending();
+    
+    /**
+     * @brief Get the message queue (for telemetry)
+     */
+    QueueHandle_t getQueue() const { return _queue; }
+    
+    /**
+     * @brief Get a copy of the apply counters
+     */
+    UIApplyStats getStats() const;
+    
+    /**
+     * @brief Trace bit of a command type (0 for CMD_UNKNOWN)
+     */
+    static uint32_t traceBit(VanSight::CommandType type) { return type < 32 ? 1UL << type : 0; }
 
 private:
     UIStateManager();
@@ -67,10 +129,23 @@ private:
     UIStateManager(const UIStateManager&) = delete;
     UIStateManager& operator=(const UIStateManager&) = delete;
     
-    void (*_lockFunc)(int);
-    void (*_unlockFunc)(void);
+    void (*_wakeFunc)(void);
+    QueueHandle_t _queue;
     bool _initialized;
     
+    // View-model: value each widget shows (-1 = unknown, LVGL task only)
+    int8_t _relayShown[VanSight::MAX_RELAYS];
+    int8_t _sensorShown[VanSight::MAX_SENSORS];
+    int8_t _connectedShown;
+    
+    UIApplyStats _stats;
+    mutable portMUX_TYPE _statsMux;
+    
+    // Apply helpers (LVGL task only)
+    void updateButtonState(lv_obj_t* buttonObj, bool isActive);
+    void updateSensorLevel(lv_obj_t* barObj, lv_obj_t* labelObj, int level);
+    void updateConnectionStatus(bool connected);
+    
     // Helper to get button object by relay number
     lv_obj_t* getButtonByRelayNum(uint8_t relayNum);
     
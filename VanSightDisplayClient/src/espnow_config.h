@@ -64,6 +64,11 @@ const lv_color_t COLOR_BUTTON_INACTIVE = lv_color_hex(0x2E2E2E); // Dark gray
 const lv_color_t COLOR_CONNECTION_LOST = lv_color_hex(0x8073E6); // Dark gray
 const lv_color_t COLOR_CONNECTION_ACTIVE = lv_color_hex(0xFFD700); // Dark gray
 
+// ============================================================================
+// UI State
+// ============================================================================
+const uint8_t UI_STATE_QUEUE_LENGTH = 8;  // State messages waiting for the LVGL task
+
 // ============================================================================
 // ESP-NOW Configuration
 // ============================================================================
@@ -71,4 +76,16 @@ const int MAX_ESPNOW_PAYLOAD = 250;
 const int ESPNOW_TIMEOUT_MS = 2000;
 const int STATUS_UPDATE_INTERVAL_MS = 5000;  // Request status every 5 seconds
 
+// ============================================================================
+// Metrics
+// ============================================================================
+const unsigned long METRICS_PRINT_INTERVAL_MS = 60000;  // Latency histograms to Serial
+
+// Resource telemetry (shown on the diagnostics screen)
+const uint32_t TELEMETRY_INTERVAL_MS = 5000;
+const uint32_t TELEMETRY_MIN_FREE_HEAP = 32768;      // Warn below this free internal heap (bytes)
+const uint32_t TELEMETRY_MIN_LARGEST_BLOCK = 16384;  // Warn when fragmented below this block size
+const uint16_t TELEMETRY_MIN_STACK_FREE = 512;       // Warn when a task has less stack left
+const uint8_t TELEMETRY_QUEUE_FILL_PERCENT = 75;     // Warn when a queue is this full
+
 #endif // ESPNOW_CONFIG_H
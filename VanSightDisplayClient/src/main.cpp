@@ -5,6 +5,7 @@
 #include "PanelManager.h"
 #include "UIStateManager.h"
 #include "SleepManager.h"
+#include "DiagnosticsScreen.h"
 
 using namespace VanSight;
 
@@ -23,11 +24,29 @@ void setup()
         return;
     }
     
-    // Initialize UI State Manager
-    UIStateManager::getInstance().init(
-        PanelManager::getInstance().getLockFunction(),
-        PanelManager::getInstance().getUnlockFunction()
-    );
+    // Initialize UI State Manager; queued state is applied by the LVGL task
+    UIStateManager::getInstance().init(PanelManager::getInstance().getWakeFunction());
+    PanelManager::getInstance().onBeforeRender([]() {
+        UIStateManager::getInstance().applyPending();
+    });
+    
+    // Hidden diagnostics screen and the telemetry it shows
+    PanelManager::getInstance().lock();
+    DiagnosticsScreen::getInstance().init();
+    PanelManager::getInstance().unlock();
+    
+    TelemetryThresholds thresholds = {
+        TELEMETRY_MIN_FREE_HEAP,
+        TELEMETRY_MIN_LARGEST_BLOCK,
+        TELEMETRY_MIN_STACK_FREE,
+        TELEMETRY_QUEUE_FILL_PERCENT
+    };
+    Telemetry::getInstance().begin(TELEMETRY_INTERVAL_MS, thresholds);
+    Telemetry::getInstance().watchTask("loopTask");
+    Telemetry::getInstance().watchTask("lvgl");
+    Telemetry::getInstance().watchTask("touch");
+    Telemetry::getInstance().watchTask("BTC_TASK");
+    Telemetry::getInstance().watchQueue("ui_state", UIStateManager::getInstance().getQueue());
     
     // Initialize Sleep Manager
     SleepManager::getInstance().init(
@@ -50,31 +69,24 @@ void loop()
 
             // BleCommandManager::getInstance().onConnectionChanged([](bool connected) {
             //                 Serial.printf("[BLE] Connection changed to %s\\n", connected? "ON" : "OFF");
-            //                 UIStateManager::getInstance().updateConnectionStatus(connected);
+            //                 UIStateManager::getInstance().postConnection(connected);
             //             });
 
             // Register data received callback
             BleCommandManager::getInstance().onDataReceived([](const AllStatusData& data) {
                 Serial.println("[BLE] Status data received from Hub");
                 
-                // Create non-const copies for UIStateManager
-                int relayStates[MAX_RELAYS];
-                int sensorLevels[MAX_SENSORS];
-                
-                memcpy(relayStates, data.relayStates, sizeof(relayStates));
-                memcpy(sensorLevels, data.sensorLevels, sizeof(sensorLevels));
-                
-                // Update UI with relay states
-                UIStateManager::getInstance().updateAllRelayStates(relayStates);
-                
-                // Update UI with sensor levels
-                UIStateManager::getInstance().updateAllSensorLevels(sensorLevels);
+                // Relays and sensors go to the LVGL task as one message
+                UIStateManager::getInstance().postStatus(data);
             });
             
-            // Register relay changed callback
-            BleCommandManager::getInstance().onRelayChanged([](uint8_t relayNum, bool state) {
-                Serial.printf("[BLE] Relay %d changed to %s\\n", relayNum, state ? "ON" : "OFF");
-                UIStateManager::getInstance().updateRelayButton(relayNum, state);
+            // Register relay change callback (single relays and deltas)
+            BleCommandManager::getInstance().onRelaysChanged([](RelayMask changed, RelayMask state, CommandType source) {
+                Serial.printf("[BLE] Relays changed: 0x%04X -> 0x%04X (%s)\n", changed, state & changed,
+                              source == CMD_UNKNOWN ? "hub" : commandTypeToString(source));
+                
+                // Latency is stamped for the command the frame answers only
+                UIStateManager::getInstance().postRelays(changed, state, UIStateManager::traceBit(source));
             });
             
             // Register connection status callback to update title color
@@ -109,5 +121,23 @@ void loop()
     
     // Update sleep manager
     SleepManager::getInstance().update();
+    Telemetry::getInstance().update();
+    
+    // Print tap-to-UI latency histograms
+    static unsigned long lastMetricsPrint = 0;
+    if (millis() - lastMetricsPrint >= METRICS_PRINT_INTERVAL_MS) {
+        lastMetricsPrint = millis();
+        LatencyMetrics::getInstance().print();
+        
+        FrameStats frames = PanelManager::getInstance().getFrameStats();
+        Serial.printf("[Panel] %s buffers: %lu frames, avg %lu ms, max %lu ms, flush avg %lu us, max %lu us\n",
+                      frames.strategy, (unsigned long)frames.frames, (unsigned long)frames.avgMs,
+                      (unsigned long)frames.maxMs, (unsigned long)frames.avgFlushUs, (unsigned long)frames.maxFlushUs);
+        
+        UIApplyStats ui = UIStateManager::getInstance().getStats();
+        Serial.printf("[UI] %lu batches, %lu messages, %lu redraws, %lu unchanged skipped, %lu dropped\n",
+                      (unsigned long)ui.batches, (unsigned long)ui.messages, (unsigned long)ui.redraws,
+                      (unsigned long)ui.skipped, (unsigned long)ui.dropped);
+    }
     delay(100);
 }
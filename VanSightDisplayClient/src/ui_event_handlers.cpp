@@ -33,6 +33,7 @@ static void handleRelayToggle(uint8_t buttonIndex, const char* buttonName) {
     lastClickTime[buttonIndex] = now;
     
     Serial.printf("%s button clicked!\n", buttonName);
+    LatencyMetrics::getInstance().stamp(CMD_RELAY_TOGGLE, STAGE_UI_EVENT);
     BleCommandManager::getInstance().toggleRelay(RELAY_MAP[buttonIndex]);
 }
 
@@ -89,11 +90,13 @@ void onBtnProjectorClick(lv_event_t * e)
 void onBtnReloadInformationClick(lv_event_t * e)
 {
     Serial.println("Reload Information button clicked!");
+    LatencyMetrics::getInstance().stamp(CMD_ALL_STATUS, STAGE_UI_EVENT);
     BleCommandManager::getInstance().requestStatus();
 }
 
 void onBtnCloseAllClick(lv_event_t * e)
 {
     Serial.println("Close All button clicked!");
+    LatencyMetrics::getInstance().stamp(CMD_ALL_RELAYS_OFF, STAGE_UI_EVENT);
     BleCommandManager::getInstance().allRelaysOff();
 }
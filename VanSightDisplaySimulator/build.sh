@@ -58,6 +58,15 @@ else
     echo ""
 fi
 
+# Trim the icon fonts to the glyphs the UI uses (fails on a missing glyph)
+python3 "$SCRIPT_DIR/../VanSightDisplayClient/squareline/subset_fonts.py" \
+    --scan "$UI_TARGET_DIR" --scan "$SCRIPT_DIR" --out "$UI_TARGET_DIR" || {
+    echo ""
+    echo "❌ Font subsetting failed!"
+    exit 1
+}
+echo ""
+
 # Clean build directory if requested
 if [ "$1" == "clean" ]; then
     echo "🧹 Cleaning build directory..."
@@ -43,6 +43,10 @@ echo ""
 echo "Uploading firmware to $DEVICE..."
 pio run -d "$SCRIPT_DIR" -t upload --upload-port "$DEVICE"
 
+echo ""
+echo "Uploading dashboard (data/) to LittleFS..."
+pio run -d "$SCRIPT_DIR" -t uploadfs --upload-port "$DEVICE"
+
 echo ""
 echo "======================================"
 echo "✓ Deploy completed successfully!"
@@ -4,6 +4,16 @@ void BuzzerManager::begin(uint8_t pin) {
     _pin = pin;
     pinMode(_pin, OUTPUT);
     digitalWrite(_pin, LOW);
+    
+    esp_timer_create_args_t args = {};
+    args.callback = &BuzzerManager::onTimer;
+    args.arg = this;
+    args.name = "buzzer";
+    if (esp_timer_create(&args, &_timer) != ESP_OK) {
+        Serial.println("[Buzzer] Timer creation failed!");
+        return;
+    }
+    
     _initialized = true;
     
     Serial.printf("[Buzzer] Initialized on pin %d\n", _pin);
@@ -15,9 +25,9 @@ void BuzzerManager::beep(uint16_t duration) {
         return;
     }
     
-    digitalWrite(_pin, HIGH);
-    delay(duration);
-    digitalWrite(_pin, LOW);
+    if (enqueue(duration, BEEP_GAP_MS)) {
+        startNext();
+    }
 }
 
 void BuzzerManager::beepPattern(uint8_t count, uint16_t duration, uint16_t pause) {
@@ -26,13 +36,82 @@ void BuzzerManager::beepPattern(uint8_t count, uint16_t duration, uint16_t pause
         return;
     }
     
+    bool queued = false;
     for (uint8_t i = 0; i < count; i++) {
+        uint16_t offMs = (i < count - 1) ? pause : BEEP_GAP_MS;
+        queued |= enqueue(duration, offMs);
+    }
+    
+    if (queued) {
+        startNext();
+    }
+}
+
+void BuzzerManager::silence() {
+    if (!_initialized) return;
+    
+    esp_timer_stop(_timer);
+    portENTER_CRITICAL(&_mux);
+    _count = 0;
+    _busy = false;
+    _phaseOn = false;
+    portEXIT_CRITICAL(&_mux);
+    digitalWrite(_pin, LOW);
+}
+
+bool BuzzerManager::enqueue(uint16_t onMs, uint16_t offMs) {
+    bool queued = false;
+    
+    portENTER_CRITICAL(&_mux);
+    // Drop feedback rather than block when the queue is full
+    if (_count < QUEUE_SIZE) {
+        uint8_t tail = (_head + _count) % QUEUE_SIZE;
+        _queue[tail].onMs = onMs;
+        _queue[tail].offMs = offMs;
+        _count++;
+        queued = true;
+    }
+    portEXIT_CRITICAL(&_mux);
+    
+    return queued;
+}
+
+void BuzzerManager::startNext() {
+    bool start = false;
+    
+    portENTER_CRITICAL(&_mux);
+    if (!_busy && _count > 0) {
+        _current = _queue[_head];
+        _head = (_head + 1) % QUEUE_SIZE;
+        _count--;
+        _busy = true;
+        _phaseOn = true;
+        start = true;
+    }
+    portEXIT_CRITICAL(&_mux);
+    
+    if (start) {
         digitalWrite(_pin, HIGH);
-        delay(duration);
-        digitalWrite(_pin, LOW);
-        
-        if (i < count - 1) {
-            delay(pause);
+        esp_timer_start_once(_timer, (uint64_t)_current.onMs * 1000);
+    }
+}
+
+void BuzzerManager::onTimer(void* arg) {
+    BuzzerManager* self = (BuzzerManager*)arg;
+    
+    // End of the ON phase: silence, then wait out the pause
+    if (self->_phaseOn) {
+        digitalWrite(self->_pin, LOW);
+        self->_phaseOn = false;
+        if (self->_current.offMs > 0) {
+            esp_timer_start_once(self->_timer, (uint64_t)self->_current.offMs * 1000);
+            return;
         }
     }
+    
+    portENTER_CRITICAL(&self->_mux);
+    self->_busy = false;
+    portEXIT_CRITICAL(&self->_mux);
+    
+    self->startNext();
 }
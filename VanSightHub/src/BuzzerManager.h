@@ -2,7 +2,15 @@
 #define BUZZER_MANAGER_H
 
 #include <Arduino.h>
+#include <esp_timer.h>
 
+/**
+ * @brief Non-blocking buzzer driven by a queued pattern
+ *
+ * beep() and beepPattern() only queue on/off steps and return at once;
+ * a one-shot esp_timer walks the queue and switches the pin, so command
+ * handlers are never held up by audio feedback.
+ */
 class BuzzerManager {
 public:
     static BuzzerManager& getInstance() {
@@ -14,13 +22,47 @@ public:
     void beep(uint16_t duration = 50);
     void beepPattern(uint8_t count = 1, uint16_t duration = 50, uint16_t pause = 100);
 
+    /**
+     * @brief Stop the current beep and drop queued steps
+     */
+    void silence();
+
+    /**
+     * @brief Check if a pattern is playing
+     */
+    bool isBusy() const { return _busy; }
+
 private:
-    BuzzerManager() : _pin(0), _initialized(false) {}
+    BuzzerManager()
+        : _pin(0), _initialized(false), _timer(nullptr),
+          _head(0), _count(0), _busy(false), _phaseOn(false),
+          _mux(portMUX_INITIALIZER_UNLOCKED) {}
     BuzzerManager(const BuzzerManager&) = delete;
     BuzzerManager& operator=(const BuzzerManager&) = delete;
 
+    struct Step {
+        uint16_t onMs;
+        uint16_t offMs;
+    };
+
+    static const uint8_t QUEUE_SIZE = 16;
+    static const uint16_t BEEP_GAP_MS = 30;  // Keeps back-to-back beeps distinct
+
     uint8_t _pin;
     bool _initialized;
+    esp_timer_handle_t _timer;
+
+    Step _queue[QUEUE_SIZE];
+    uint8_t _head;
+    uint8_t _count;
+    volatile bool _busy;
+    bool _phaseOn;
+    Step _current;
+    portMUX_TYPE _mux;
+
+    bool enqueue(uint16_t onMs, uint16_t offMs);
+    void startNext();
+    static void onTimer(void* arg);
 };
 
 #endif // BUZZER_MANAGER_H
@@ -0,0 +1,78 @@
+#include "CalibrationTable.h"
+
+CalibrationTable::CalibrationTable()
+    : _count(0) {
+}
+
+bool CalibrationTable::addPoint(uint16_t raw, uint16_t level) {
+    if (level > 1000) return false;
+    
+    // Find insert position, replacing an identical raw value
+    uint8_t pos = 0;
+    while (pos < _count && _points[pos].raw < raw) {
+        pos++;
+    }
+    
+    if (pos < _count && _points[pos].raw == raw) {
+        _points[pos].level = level;
+        return true;
+    }
+    
+    if (_count >= MAX_POINTS) return false;
+    
+    for (uint8_t i = _count; i > pos; i--) {
+        _points[i] = _points[i - 1];
+    }
+    _points[pos].raw = raw;
+    _points[pos].level = level;
+    _count++;
+    return true;
+}
+
+void CalibrationTable::clear() {
+    _count = 0;
+}
+
+bool CalibrationTable::setPoints(const CalibrationPoint* points, uint8_t count) {
+    if (count > MAX_POINTS) return false;
+    
+    for (uint8_t i = 0; i < count; i++) {
+        if (points[i].level > 1000) return false;
+        if (i > 0 && points[i].raw <= points[i - 1].raw) return false;
+    }
+    
+    for (uint8_t i = 0; i < count; i++) {
+        _points[i] = points[i];
+    }
+    _count = count;
+    return true;
+}
+
+uint16_t CalibrationTable::lookup(uint16_t raw) const {
+    if (_count == 0) return 0;
+    if (raw <= _points[0].raw) return _points[0].level;
+    if (raw >= _points[_count - 1].raw) return _points[_count - 1].level;
+    
+    // Binary search for the segment [lo, lo + 1] containing raw
+    uint8_t lo = 0;
+    uint8_t hi = _count - 1;
+    while (hi - lo > 1) {
+        uint8_t mid = (lo + hi) / 2;
+        if (_points[mid].raw <= raw) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    
+    const CalibrationPoint& a = _points[lo];
+    const CalibrationPoint& b = _points[hi];
+    int32_t span = b.raw - a.raw;
+    int32_t delta = (int32_t)b.level - (int32_t)a.level;
+    int32_t offset = raw - a.raw;
+    
+    // Rounded integer interpolation (works for falling senders too)
+    int32_t scaled = delta * offset;
+    scaled += (scaled >= 0 ? span / 2 : -span / 2);
+    return (uint16_t)(a.level + scaled / span);
+}
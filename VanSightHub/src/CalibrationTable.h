@@ -0,0 +1,68 @@
+#ifndef CALIBRATION_TABLE_H
+#define CALIBRATION_TABLE_H
+
+#include <stdint.h>
+
+/**
+ * @brief One calibration point: raw ADC code -> level
+ */
+struct CalibrationPoint {
+    uint16_t raw;       // Filtered raw ADC value (0-4095)
+    uint16_t level;     // Level in permille (0-1000)
+};
+
+/**
+ * @brief Piecewise-linear raw-to-level table
+ *
+ * Points are kept sorted by raw value. Lookups binary-search the segment
+ * and interpolate in integer arithmetic, so non-linear tank senders can be
+ * mapped without floats. Raw values outside the table clamp to the end
+ * points.
+ */
+class CalibrationTable {
+public:
+    static const uint8_t MAX_POINTS = 16;
+    
+    CalibrationTable();
+    
+    /**
+     * @brief Add a point, replacing an existing point with the same raw value
+     *
+     * @return true if added, false if the table is full or level is out of range
+     */
+    bool addPoint(uint16_t raw, uint16_t level);
+    
+    /**
+     * @brief Remove all points
+     */
+    void clear();
+    
+    /**
+     * @brief Check if the table can be used (at least two points)
+     */
+    bool isValid() const { return _count >= 2; }
+    
+    /**
+     * @brief Map a raw value to a level
+     *
+     * @param raw Raw ADC value
+     * @return uint16_t Level in permille (0-1000)
+     */
+    uint16_t lookup(uint16_t raw) const;
+    
+    /**
+     * @brief Replace the table with stored points
+     *
+     * @return true if the points were valid and sorted
+     */
+    bool setPoints(const CalibrationPoint* points, uint8_t count);
+    
+    const CalibrationPoint* getPoints() const { return _points; }
+    uint8_t getCount() const { return _count; }
+    
+private:
+    CalibrationPoint _points[MAX_POINTS];
+    uint8_t _count;
+};
+
+#endif // CALIBRATION_TABLE_H
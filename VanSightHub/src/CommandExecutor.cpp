@@ -0,0 +1,200 @@
+#include "CommandExecutor.h"
+#include <esp_timer.h>
+
+using namespace VanSight;
+
+// Queue depth per lane
+static const UBaseType_t LANE_DEPTH[LANE_COUNT] = { 4, 8, 4 };
+
+// Suggested retry delay when a lane is full
+static const uint32_t MIN_RETRY_MS = 50;
+
+CommandExecutor::CommandExecutor()
+    : _task(nullptr),
+      _execute(nullptr),
+      _statsMux(portMUX_INITIALIZER_UNLOCKED) {
+    for (int i = 0; i < LANE_COUNT; i++) {
+        _lanes[i] = nullptr;
+        memset(&_stats[i], 0, sizeof(LaneStats));
+        _printed[i] = 0;
+    }
+}
+
+bool CommandExecutor::begin(std::function<void(const Command&)> execute, UBaseType_t priority) {
+    if (_task) {
+        return true;
+    }
+    
+    _execute = execute;
+    for (int i = 0; i < LANE_COUNT; i++) {
+        _lanes[i] = xQueueCreate(LANE_DEPTH[i], sizeof(Job));
+        if (!_lanes[i]) {
+            Serial.println("[Executor] Lane allocation failed");
+            return false;
+        }
+    }
+    
+    if (xTaskCreate(taskEntry, "cmd_exec", 6144, this, priority, &_task) != pdPASS) {
+        Serial.println("[Executor] Task creation failed");
+        _task = nullptr;
+        return false;
+    }
+    
+    Serial.println("[Executor] Command executor started");
+    return true;
+}
+
+CommandLane CommandExecutor::laneFor(CommandType type) {
+    switch (type) {
+        case CMD_ALL_RELAYS_OFF:
+            return LANE_CRITICAL;
+        case CMD_RELAY_TOGGLE:
+        case CMD_RELAY_ON:
+        case CMD_RELAY_OFF:
+        case CMD_RELAY_SET:
+        case CMD_RELAYS_SET:
+        case CMD_ALL_RELAYS_ON:
+        case CMD_RELAY_PULSE:
+        case CMD_SCENE_APPLY:
+        case CMD_SCENE_SAVE:
+        case CMD_SCENE_DELETE:
+        case CMD_TIMER_ADD:
+        case CMD_TIMER_CANCEL:
+        case CMD_CALIBRATE_POINT:
+        case CMD_CALIBRATE_CLEAR:
+            return LANE_CONTROL;
+        default:
+            return LANE_QUERY;
+    }
+}
+
+const char* CommandExecutor::laneName(CommandLane lane) {
+    switch (lane) {
+        case LANE_CRITICAL: return "critical";
+        case LANE_CONTROL: return "control";
+        case LANE_QUERY: return "query";
+        default: return "unknown";
+    }
+}
+
+bool CommandExecutor::submit(const Command& cmd, JsonDocument& response) {
+    if (!_task) {
+        return false;
+    }
+    
+    CommandLane lane = laneFor(cmd);
+    Job job;
+    job.command = cmd;
+    job.submittedUs = esp_timer_get_time();
+    
+    if (xQueueSend(_lanes[lane], &job, 0) != pdTRUE) {
+        portENTER_CRITICAL(&_statsMux);
+        LaneStats& stats = _stats[lane];
+        stats.dropped++;
+        uint32_t avgExecUs = stats.executed ? (uint32_t)(stats.totalExecUs / stats.executed) : 0;
+        portEXIT_CRITICAL(&_statsMux);
+        Serial.printf("[Executor] %s lane full\n", laneName(lane));
+        
+        // Never lose a safety command: run it in the caller instead
+        if (lane == LANE_CRITICAL) {
+            return false;
+        }
+        
+        // Roughly the time to drain the lane at its average execution time
+        uint32_t retryMs = max(MIN_RETRY_MS, avgExecUs * LANE_DEPTH[lane] / 1000);
+        
+        // Same shape as the rate limiter's answer
+        response["status"] = "busy";
+        JsonObject data = response["data"].to<JsonObject>();
+        data["cmd"] = commandTypeToString(cmd.type);
+        data["retry_ms"] = retryMs;
+        response["message"] = "Command queue full, retry later";
+        return false;
+    }
+    
+    xTaskNotifyGive(_task);
+    return true;
+}
+
+void CommandExecutor::taskEntry(void* arg) {
+    ((CommandExecutor*)arg)->run();
+}
+
+void CommandExecutor::run() {
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        
+        // Always restart from the highest-priority lane after each job
+        bool ran = true;
+        while (ran) {
+            ran = false;
+            for (int lane = 0; lane < LANE_COUNT; lane++) {
+                Job job;
+                if (xQueueReceive(_lanes[lane], &job, 0) != pdTRUE) {
+                    continue;
+                }
+                
+                int64_t start = esp_timer_get_time();
+                if (_execute) {
+                    _execute(job.command);
+                }
+                int64_t end = esp_timer_get_time();
+                
+                record((CommandLane)lane, (uint32_t)(start - job.submittedUs), (uint32_t)(end - start));
+                ran = true;
+                break;
+            }
+        }
+    }
+}
+
+void CommandExecutor::record(CommandLane lane, uint32_t queueUs, uint32_t execUs) {
+    portENTER_CRITICAL(&_statsMux);
+    LaneStats& stats = _stats[lane];
+    stats.executed++;
+    stats.totalQueueUs += queueUs;
+    stats.totalExecUs += execUs;
+    if (queueUs > stats.maxQueueUs) stats.maxQueueUs = queueUs;
+    if (execUs > stats.maxExecUs) stats.maxExecUs = execUs;
+    portEXIT_CRITICAL(&_statsMux);
+}
+
+LaneStats CommandExecutor::getStats(CommandLane lane) const {
+    LaneStats copy;
+    portENTER_CRITICAL(&_statsMux);
+    copy = _stats[lane];
+    portEXIT_CRITICAL(&_statsMux);
+    return copy;
+}
+
+void CommandExecutor::toJson(JsonObject out) const {
+    JsonArray lanes = out["lanes"].to<JsonArray>();
+    for (int l = 0; l < LANE_COUNT; l++) {
+        LaneStats stats = getStats((CommandLane)l);
+        JsonObject lane = lanes.add<JsonObject>();
+        lane["lane"] = laneName((CommandLane)l);
+        lane["executed"] = stats.executed;
+        lane["dropped"] = stats.dropped;
+        lane["queue_avg_us"] = stats.executed ? (uint32_t)(stats.totalQueueUs / stats.executed) : 0;
+        lane["queue_max_us"] = stats.maxQueueUs;
+        lane["exec_avg_us"] = stats.executed ? (uint32_t)(stats.totalExecUs / stats.executed) : 0;
+        lane["exec_max_us"] = stats.maxExecUs;
+    }
+}
+
+void CommandExecutor::printStats() {
+    for (int l = 0; l < LANE_COUNT; l++) {
+        LaneStats stats = getStats((CommandLane)l);
+        uint32_t total = stats.executed + stats.dropped;
+        if (total == _printed[l]) {
+            continue;
+        }
+        _printed[l] = total;
+        
+        uint32_t count = stats.executed ? stats.executed : 1;
+        Serial.printf("[Executor] %s: %u run, %u dropped, wait %u/%u us, exec %u/%u us (avg/max)\n",
+                      laneName((CommandLane)l), stats.executed, stats.dropped,
+                      (uint32_t)(stats.totalQueueUs / count), stats.maxQueueUs,
+                      (uint32_t)(stats.totalExecUs / count), stats.maxExecUs);
+    }
+}
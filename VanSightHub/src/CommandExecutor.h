@@ -0,0 +1,127 @@
+#ifndef COMMAND_EXECUTOR_H
+#define COMMAND_EXECUTOR_H
+
+#include <Arduino.h>
+#include <VanSightLib.h>
+#include <ArduinoJson.h>
+#include <functional>
+
+/**
+ * @brief Priority lanes of the command executor (lower runs first)
+ */
+enum CommandLane {
+    LANE_CRITICAL = 0,  // Safety commands (all relays off)
+    LANE_CONTROL,       // Relay / scene changes
+    LANE_QUERY,         // Status reads
+    LANE_COUNT
+};
+
+/**
+ * @brief Latency counters of one lane
+ */
+struct LaneStats {
+    uint32_t executed;
+    uint32_t dropped;
+    uint32_t maxQueueUs;        // Worst wait between submit and start
+    uint32_t maxExecUs;         // Worst execution time
+    uint64_t totalQueueUs;
+    uint64_t totalExecUs;
+};
+
+/**
+ * @brief Runs radio commands on a dedicated task
+ *
+ * Transports submit parsed commands and return immediately; the executor
+ * task always takes the oldest command of the highest-priority non-empty
+ * lane, so an all-off never waits behind queued status reads.
+ */
+class CommandExecutor {
+public:
+    /**
+     * @brief Get singleton instance
+     */
+    static CommandExecutor& getInstance() {
+        static CommandExecutor instance;
+        return instance;
+    }
+    
+    /**
+     * @brief Create the lanes and start the executor task
+     *
+     * @param execute Function that runs one command (in the executor task)
+     * @param priority FreeRTOS priority of the executor task
+     * @return true if successful
+     */
+    bool begin(std::function<void(const VanSight::Command&)> execute, UBaseType_t priority = 3);
+    
+    /**
+     * @brief Queue a command on its lane
+     *
+     * A full control or query lane drops the command and fills response
+     * with a "busy" reply for the requester. A full critical lane leaves
+     * response empty: the caller must run the command itself.
+     *
+     * @param response Filled with the busy reply when the command is dropped
+     * @return true if the command was queued
+     */
+    bool submit(const VanSight::Command& cmd, JsonDocument& response);
+    
+    /**
+     * @brief Get the lane a command runs on
+     */
+    static CommandLane laneFor(const VanSight::Command& cmd) { return laneFor(cmd.type); }
+    
+    /**
+     * @brief Get the lane a command type runs on
+     */
+    static CommandLane laneFor(VanSight::CommandType type);
+    
+    /**
+     * @brief Get a copy of a lane's counters
+     */
+    LaneStats getStats(CommandLane lane) const;
+    
+    /**
+     * @brief Write the lane counters for the telemetry command
+     */
+    void toJson(JsonObject out) const;
+    
+    /**
+     * @brief Log the lanes that ran or dropped commands since the last call
+     */
+    void printStats();
+    
+    /**
+     * @brief Get the queue behind a lane (for telemetry)
+     */
+    QueueHandle_t getQueue(CommandLane lane) const { return _lanes[lane]; }
+    
+    /**
+     * @brief Get the lane name for logs and reports
+     */
+    static const char* laneName(CommandLane lane);
+    
+private:
+    CommandExecutor();
+    CommandExecutor(const CommandExecutor&) = delete;
+    CommandExecutor& operator=(const CommandExecutor&) = delete;
+    
+    struct Job {
+        VanSight::Command command;
+        int64_t submittedUs;
+    };
+    
+    QueueHandle_t _lanes[LANE_COUNT];
+    TaskHandle_t _task;
+    std::function<void(const VanSight::Command&)> _execute;
+    
+    LaneStats _stats[LANE_COUNT];
+    uint32_t _printed[LANE_COUNT];  // executed + dropped at the last print
+    mutable portMUX_TYPE _statsMux;
+    
+    static void taskEntry(void* arg);
+    void run();
+    void record(CommandLane lane, uint32_t queueUs, uint32_t execUs);
+};
+
+#endif // COMMAND_EXECUTOR_H
@@ -1,10 +1,54 @@
 #include "CommandHandler.h"
 
-CommandHandler::CommandHandler(RelayController& relayCtrl, SensorController& sensorCtrl)
-    : _relayController(relayCtrl), _sensorController(sensorCtrl) {
+CommandHandler::CommandHandler(RelayController& relayCtrl, SensorController& sensorCtrl, StatusStore& statusStore,
+                               HistoryStore& historyStore, SceneStore& sceneStore, RelayTimerWheel& relayTimers)
+    : _relayController(relayCtrl), _sensorController(sensorCtrl), _statusStore(statusStore),
+      _historyStore(historyStore), _sceneStore(sceneStore), _relayTimers(relayTimers) {
 }
 
-bool CommandHandler::processCommand(const uint8_t* data, int len, JsonDocument& response) {
+void CommandHandler::registerCommands(VanSight::CommandRegistry& registry) {
+    using namespace VanSight;
+    typedef JsonDocument& Doc;
+    
+    // Relays
+    registry.on(CMD_RELAY_ON, [this](Doc doc, Doc response) { handleRelayOn(doc, response); });
+    registry.on(CMD_RELAY_OFF, [this](Doc doc, Doc response) { handleRelayOff(doc, response); });
+    registry.on(CMD_RELAY_TOGGLE, [this](Doc doc, Doc response) { handleRelayToggle(doc, response); });
+    registry.on(CMD_RELAY_SET, [this](Doc doc, Doc response) { handleRelaySet(doc, response); });
+    registry.on(CMD_RELAYS_SET, [this](Doc doc, Doc response) { handleRelaysSet(doc, response); });
+    registry.on(CMD_RELAY_STATUS, [this](Doc doc, Doc response) { handleRelayStatus(doc, response); });
+    registry.on(CMD_ALL_RELAYS_ON, [this](Doc, Doc response) { handleAllRelaysOn(response); });
+    registry.on(CMD_ALL_RELAYS_OFF, [this](Doc, Doc response) { handleAllRelaysOff(response); });
+    registry.on(CMD_ALL_RELAY_STATUS, [this](Doc, Doc response) { handleAllRelayStatus(response); });
+    
+    // Sensors and status
+    registry.on(CMD_SENSOR_READ, [this](Doc doc, Doc response) { handleSensorStatus(doc, response); });
+    registry.on(CMD_ALL_SENSOR_STATUS, [this](Doc, Doc response) { handleAllSensorStatus(response); });
+    registry.on(CMD_ALL_STATUS, [this](Doc, Doc response) { handleAllStatus(response); });
+    registry.on(CMD_CALIBRATE_POINT, [this](Doc doc, Doc response) { handleCalibratePoint(doc, response); });
+    registry.on(CMD_CALIBRATE_CLEAR, [this](Doc doc, Doc response) { handleCalibrateClear(doc, response); });
+    registry.on(CMD_CALIBRATION_STATUS, [this](Doc doc, Doc response) { handleCalibrationStatus(doc, response); });
+    
+    // History
+    registry.on(CMD_SENSOR_HISTORY, [this](Doc doc, Doc response) { handleSensorHistory(doc, response); });
+    registry.on(CMD_RELAY_HISTORY, [this](Doc doc, Doc response) { handleRelayHistory(doc, response); });
+    
+    // Scenes and timers
+    registry.on(CMD_SCENE_SAVE, [this](Doc doc, Doc response) { handleSceneSave(doc, response); });
+    registry.on(CMD_SCENE_APPLY, [this](Doc doc, Doc response) { handleSceneApply(doc, response); });
+    registry.on(CMD_SCENE_DELETE, [this](Doc doc, Doc response) { handleSceneDelete(doc, response); });
+    registry.on(CMD_SCENE_LIST, [this](Doc, Doc response) { handleSceneList(response); });
+    registry.on(CMD_TIMER_ADD, [this](Doc doc, Doc response) { handleTimerAdd(doc, response); });
+    registry.on(CMD_RELAY_PULSE, [this](Doc doc, Doc response) { handleRelayPulse(doc, response); });
+    registry.on(CMD_TIMER_CANCEL, [this](Doc doc, Doc response) { handleTimerCancel(doc, response); });
+    registry.on(CMD_TIMER_LIST, [this](Doc, Doc response) { handleTimerList(response); });
+    
+    // Diagnostics
+    registry.on(CMD_METRICS, [this](Doc doc, Doc response) { handleMetrics(doc, response); });
+    registry.on(CMD_TELEMETRY, [this](Doc, Doc response) { handleTelemetry(response); });
+}
+
+bool CommandHandler::processCommand(const uint8_t* data, int len, JsonDocument& response, uint32_t peer) {
     // Parse JSON command
     JsonDocument doc;
     DeserializationError error = deserializeJson(doc, data, len);
@@ -27,43 +71,13 @@ bool CommandHandler::processCommand(const uint8_t* data, int len, JsonDocument&
     if (doc.containsKey("sensor")) Serial.printf(" (Sensor %d)", (int)doc["sensor"]);
     Serial.println();
     
-    // Route to appropriate handler
-    if (strcmp(cmd, "relay_on") == 0) {
-        handleRelayOn(doc, response);
-    }
-    else if (strcmp(cmd, "relay_off") == 0) {
-        handleRelayOff(doc, response);
-    }
-    else if (strcmp(cmd, "relay_toggle") == 0) {
-        handleRelayToggle(doc, response);
-    }
-    else if (strcmp(cmd, "relay_status") == 0) {
-        handleRelayStatus(doc, response);
-    }
-    else if (strcmp(cmd, "all_relays_on") == 0) {
-        handleAllRelaysOn(response);
-    }
-    else if (strcmp(cmd, "all_relays_off") == 0) {
-        handleAllRelaysOff(response);
-    }
-    else if (strcmp(cmd, "all_relay_status") == 0) {
-        handleAllRelayStatus(response);
-    }
-    else if (strcmp(cmd, "sensor_status") == 0) {
-        handleSensorStatus(doc, response);
-    }
-    else if (strcmp(cmd, "all_sensor_status") == 0) {
-        handleAllSensorStatus(response);
-    }
-    else if (strcmp(cmd, "all_status") == 0) {
-        handleAllStatus(response);
-    }
-    else {
-        sendError(response, "Unknown command");
+    // Answer "busy" before anything touches GPIO, the buzzer or a broadcast
+    if (peer && !RateLimiter::getInstance().admit(peer, VanSight::stringToCommandType(cmd), response)) {
         return false;
     }
     
-    return true;
+    // Same handlers as the radio transports
+    return VanSight::CommandRegistry::getInstance().dispatch(doc, response);
 }
 
 // ============================================================================
@@ -75,8 +89,6 @@ void CommandHandler::handleRelayOn(JsonDocument& doc, JsonDocument& response) {
     
     if (_relayController.turnOn(relayNum)) {
         JsonDocument data;
-        data["relay"] = relayNum;
-        data["state"] = "on";
         sendSuccess(response, data, "Relay turned ON");
         Serial.printf("Relay %d: ON\n", relayNum);
     } else {
@@ -89,8 +101,6 @@ void CommandHandler::handleRelayOff(JsonDocument& doc, JsonDocument& response) {
     
     if (_relayController.turnOff(relayNum)) {
         JsonDocument data;
-        data["relay"] = relayNum;
-        data["state"] = "off";
         sendSuccess(response, data, "Relay turned OFF");
         Serial.printf("Relay %d: OFF\n", relayNum);
     } else {
@@ -104,8 +114,6 @@ void CommandHandler::handleRelayToggle(JsonDocument& doc, JsonDocument& response
     if (_relayController.toggle(relayNum)) {
         bool state = _relayController.getState(relayNum);
         JsonDocument data;
-        data["relay"] = relayNum;
-        data["state"] = state ? "on" : "off";
         sendSuccess(response, data, "Relay toggled");
         Serial.printf("Relay %d toggled: %s\n", relayNum, state ? "ON" : "OFF");
     } else {
@@ -113,6 +121,42 @@ void CommandHandler::handleRelayToggle(JsonDocument& doc, JsonDocument& response
     }
 }
 
+void CommandHandler::handleRelaySet(JsonDocument& doc, JsonDocument& response) {
+    VanSight::Command cmd;
+    if (!VanSight::CommandParser::parse(doc, cmd)) {
+        sendError(response, "Expected relay (1-16) and state (on/off)");
+        return;
+    }
+    
+    int relayNum = cmd.params.relaySet.relayNum;
+    bool state = cmd.params.relaySet.state;
+    bool ok = state ? _relayController.turnOn(relayNum) : _relayController.turnOff(relayNum);
+    
+    if (ok) {
+        JsonDocument data;
+        sendSuccess(response, data, "Relay set");
+        Serial.printf("Relay %d set: %s\n", relayNum, state ? "ON" : "OFF");
+    } else {
+        sendError(response, "Invalid relay number (1-16)");
+    }
+}
+
+void CommandHandler::handleRelaysSet(JsonDocument& doc, JsonDocument& response) {
+    VanSight::Command cmd;
+    if (!VanSight::CommandParser::parse(doc, cmd)) {
+        sendError(response, "Expected mask and values");
+        return;
+    }
+    
+    VanSight::RelayMask before = _relayController.set(cmd.params.relays.mask, cmd.params.relays.values);
+    
+    // Plain ack; the new mask reaches clients through the relay delta broadcast
+    JsonDocument data;
+    sendSuccess(response, data, "Relays set");
+    Serial.printf("Relays set: mask 0x%04X, 0x%04X -> 0x%04X\n",
+                  cmd.params.relays.mask, before, _relayController.getMask());
+}
+
 void CommandHandler::handleRelayStatus(JsonDocument& doc, JsonDocument& response) {
     int relayNum = doc["relay"] | 0;
     
@@ -158,8 +202,8 @@ void CommandHandler::handleAllRelayStatus(JsonDocument& response) {
 void CommandHandler::handleSensorStatus(JsonDocument& doc, JsonDocument& response) {
     int sensorNum = doc["sensor"] | 0;
     
-    float resistance = _sensorController.readResistance(sensorNum);
-    int level = _sensorController.readLevel(sensorNum);
+    float resistance = _statusStore.getSensorResistance(sensorNum);
+    int level = _statusStore.getSensorLevel(sensorNum);
     
     if (resistance >= 0 && level >= 0) {
         JsonDocument data;
@@ -176,10 +220,10 @@ void CommandHandler::handleAllSensorStatus(JsonDocument& response) {
     JsonDocument data;
     JsonArray sensors = data["sensors"].to<JsonArray>();
     
-    for (int i = 1; i <= _sensorController.getCount(); i++) {
+    for (int i = 1; i <= _statusStore.getSensorCount(); i++) {
         JsonObject sensor = sensors.add<JsonObject>();
-        float resistance = _sensorController.readResistance(i);
-        int level = _sensorController.readLevel(i);
+        float resistance = _statusStore.getSensorResistance(i);
+        int level = _statusStore.getSensorLevel(i);
         
         sensor["id"] = i;
         sensor["resistance"] = round(resistance * 10) / 10.0;
@@ -198,16 +242,17 @@ void CommandHandler::handleAllStatus(JsonDocument& response) {
     
     // Relays
     JsonArray relays = data["relays"].to<JsonArray>();
-    for (int i = 1; i <= _relayController.getCount(); i++) {
-        relays.add(_relayController.getState(i) ? 1 : 0);
+    VanSight::RelayMask mask = _statusStore.getRelayMask();
+    for (int i = 0; i < _statusStore.getRelayCount(); i++) {
+        relays.add((mask >> i) & 1);
     }
     
     // Sensors
     JsonArray sensors = data["sensors"].to<JsonArray>();
-    for (int i = 1; i <= _sensorController.getCount(); i++) {
+    for (int i = 1; i <= _statusStore.getSensorCount(); i++) {
         JsonObject sensor = sensors.add<JsonObject>();
-        float resistance = _sensorController.readResistance(i);
-        int level = _sensorController.readLevel(i);
+        float resistance = _statusStore.getSensorResistance(i);
+        int level = _statusStore.getSensorLevel(i);
         
         sensor["id"] = i;
         sensor["resistance"] = round(resistance * 10) / 10.0;
@@ -217,6 +262,393 @@ void CommandHandler::handleAllStatus(JsonDocument& response) {
     sendSuccess(response, data, "Complete system status");
 }
 
+// ============================================================================
+// CALIBRATION HANDLERS
+// ============================================================================
+
+void CommandHandler::handleCalibratePoint(JsonDocument& doc, JsonDocument& response) {
+    int sensorNum = doc["sensor"] | 0;
+    float level = doc["level"] | -1.0f;
+    
+    if (level < 0 || level > 100) {
+        sendError(response, "Invalid level (0-100)");
+        return;
+    }
+    
+    // Capture the current filtered reading at the given level
+    int raw = -1;
+    uint16_t permille = (uint16_t)(level * 10 + 0.5f);
+    if (!_sensorController.addCalibrationPoint(sensorNum, permille, raw)) {
+        sendError(response, "Calibration point not stored");
+        return;
+    }
+    
+    JsonDocument data;
+    data["sensor"] = sensorNum;
+    data["raw"] = raw;
+    data["level"] = level;
+    data["points"] = _sensorController.getCalibration(sensorNum)->getCount();
+    sendSuccess(response, data, "Calibration point stored");
+    Serial.printf("Sensor %d: calibration point raw %d -> %.1f%%\n", sensorNum, raw, level);
+}
+
+void CommandHandler::handleCalibrateClear(JsonDocument& doc, JsonDocument& response) {
+    int sensorNum = doc["sensor"] | 0;
+    
+    if (_sensorController.clearCalibration(sensorNum)) {
+        JsonDocument data;
+        data["sensor"] = sensorNum;
+        sendSuccess(response, data, "Calibration cleared");
+    } else {
+        sendError(response, "Invalid sensor number (1-3)");
+    }
+}
+
+void CommandHandler::handleCalibrationStatus(JsonDocument& doc, JsonDocument& response) {
+    int sensorNum = doc["sensor"] | 0;
+    
+    const CalibrationTable* table = _sensorController.getCalibration(sensorNum);
+    if (!table) {
+        sendError(response, "Invalid sensor number (1-3)");
+        return;
+    }
+    
+    JsonDocument data;
+    data["sensor"] = sensorNum;
+    data["raw"] = _sensorController.readRaw(sensorNum);
+    data["active"] = table->isValid();
+    
+    // Points as [raw, level%] pairs
+    JsonArray points = data["points"].to<JsonArray>();
+    for (uint8_t i = 0; i < table->getCount(); i++) {
+        JsonArray point = points.add<JsonArray>();
+        point.add(table->getPoints()[i].raw);
+        point.add(table->getPoints()[i].level / 10.0);
+    }
+    
+    sendSuccess(response, data, "Calibration table");
+}
+
+// ============================================================================
+// HISTORY HANDLERS
+// ============================================================================
+
+void CommandHandler::handleSensorHistory(JsonDocument& doc, JsonDocument& response) {
+    int sensorNum = doc["sensor"] | 0;
+    uint32_t range = doc["range"] | 3600;     // Seconds back from now
+    uint16_t points = doc["points"] | 60;
+    
+    uint32_t now = _historyStore.now();
+    uint32_t from = range < now ? now - range : 0;
+    
+    int16_t levels[HistoryStore::MAX_QUERY_POINTS];
+    uint32_t step = 0;
+    int count = _historyStore.querySensor(sensorNum, from, now + 1, points, levels, step);
+    if (count < 0) {
+        sendError(response, "Invalid sensor number (1-3)");
+        return;
+    }
+    
+    // Compact frame: start + step, one level per point (-1 = no data)
+    JsonDocument data;
+    data["sensor"] = sensorNum;
+    data["now"] = now;
+    data["from"] = from;
+    data["step"] = step;
+    JsonArray values = data["levels"].to<JsonArray>();
+    for (int i = 0; i < count; i++) {
+        values.add(levels[i]);
+    }
+    
+    sendSuccess(response, data);
+}
+
+void CommandHandler::handleRelayHistory(JsonDocument& doc, JsonDocument& response) {
+    uint32_t range = doc["range"] | 86400;
+    
+    uint32_t now = _historyStore.now();
+    uint32_t from = range < now ? now - range : 0;
+    
+    RelayEvent events[32];
+    int count = _historyStore.queryRelays(from, now + 1, events, 32);
+    
+    // Events as [time, mask] pairs, oldest first
+    JsonDocument data;
+    data["now"] = now;
+    JsonArray list = data["events"].to<JsonArray>();
+    for (int i = 0; i < count; i++) {
+        JsonArray event = list.add<JsonArray>();
+        event.add(events[i].time);
+        event.add(events[i].mask);
+    }
+    
+    sendSuccess(response, data);
+}
+
+// ============================================================================
+// SCENE HANDLERS
+// ============================================================================
+
+void CommandHandler::handleSceneSave(JsonDocument& doc, JsonDocument& response) {
+    const char* name = doc["name"];
+    
+    // Without an explicit mask the current relay states are captured
+    VanSight::RelayMask target = doc["mask"] | _relayController.getMask();
+    VanSight::RelayMask care = doc["care"] | 0xFFFF;
+    
+    if (_sceneStore.save(name, target, care)) {
+        JsonDocument data;
+        data["name"] = name;
+        data["mask"] = target & care;
+        data["care"] = care;
+        sendSuccess(response, data, "Scene saved");
+    } else {
+        sendError(response, "Scene not saved (name 1-15 chars, max 8 scenes)");
+    }
+}
+
+void CommandHandler::handleSceneApply(JsonDocument& doc, JsonDocument& response) {
+    const char* name = doc["name"];
+    
+    Scene scene;
+    if (!_sceneStore.find(name, scene)) {
+        sendError(response, "Unknown scene");
+        return;
+    }
+    
+    // Only the scene's relays switch, in one write under the controller lock;
+    // clients learn the new states from the relay delta broadcast
+    VanSight::RelayMask before = _relayController.set(scene.care, scene.target);
+    VanSight::RelayMask after = scene.applyTo(before);
+    
+    JsonDocument data;
+    data["name"] = scene.name;
+    sendSuccess(response, data, "Scene applied");
+    Serial.printf("Scene '%s' applied: 0x%04X -> 0x%04X\n", scene.name, before, after);
+}
+
+void CommandHandler::handleSceneDelete(JsonDocument& doc, JsonDocument& response) {
+    const char* name = doc["name"];
+    
+    if (_sceneStore.remove(name)) {
+        JsonDocument data;
+        data["name"] = name;
+        sendSuccess(response, data, "Scene deleted");
+    } else {
+        sendError(response, "Unknown scene");
+    }
+}
+
+void CommandHandler::handleSceneList(JsonDocument& response) {
+    JsonDocument data;
+    JsonArray scenes = data["scenes"].to<JsonArray>();
+    
+    for (uint8_t i = 0; i < _sceneStore.getCount(); i++) {
+        const Scene& scene = _sceneStore.at(i);
+        JsonObject item = scenes.add<JsonObject>();
+        item["name"] = scene.name;
+        item["mask"] = scene.target;
+        item["care"] = scene.care;
+    }
+    
+    sendSuccess(response, data, "Scenes");
+}
+
+// ============================================================================
+// TIMER HANDLERS
+// ============================================================================
+
+static const char* timerActionToString(TimerAction action) {
+    switch (action) {
+        case TIMER_RELAY_ON: return "on";
+        case TIMER_RELAY_TOGGLE: return "toggle";
+        default: return "off";
+    }
+}
+
+void CommandHandler::handleTimerAdd(JsonDocument& doc, JsonDocument& response) {
+    int relayNum = doc["relay"] | 0;
+    uint32_t delaySeconds = doc["delay"] | 0;
+    const char* actionName = doc["action"] | "off";
+    
+    if (relayNum < 1 || relayNum > (int)_relayController.getCount()) {
+        sendError(response, "Invalid relay number (1-16)");
+        return;
+    }
+    if (delaySeconds == 0) {
+        sendError(response, "Missing 'delay' (seconds)");
+        return;
+    }
+    
+    // A typo must not silently schedule a shutdown
+    TimerAction action;
+    if (strcmp(actionName, "off") == 0) action = TIMER_RELAY_OFF;
+    else if (strcmp(actionName, "on") == 0) action = TIMER_RELAY_ON;
+    else if (strcmp(actionName, "toggle") == 0) action = TIMER_RELAY_TOGGLE;
+    else {
+        sendError(response, "Invalid 'action' (on/off/toggle)");
+        return;
+    }
+    
+    uint32_t id = _relayTimers.add(_historyStore.now(), delaySeconds, relayNum, action);
+    if (id == 0) {
+        sendError(response, "Too many timers");
+        return;
+    }
+    
+    JsonDocument data;
+    data["id"] = id;
+    data["relay"] = relayNum;
+    data["action"] = timerActionToString(action);
+    data["delay"] = delaySeconds;
+    sendSuccess(response, data, "Timer added");
+}
+
+void CommandHandler::handleRelayPulse(JsonDocument& doc, JsonDocument& response) {
+    int relayNum = doc["relay"] | 0;
+    uint32_t duration = doc["duration"] | 0;
+    
+    if (duration == 0) {
+        sendError(response, "Missing 'duration' (seconds)");
+        return;
+    }
+    if (relayNum < 1 || relayNum > (int)_relayController.getCount()) {
+        sendError(response, "Invalid relay number (1-16)");
+        return;
+    }
+    
+    // Reserve the auto-off before energising, so a full pool never leaves
+    // the relay on without one
+    uint32_t id = _relayTimers.add(_historyStore.now(), duration, relayNum, TIMER_RELAY_OFF);
+    if (id == 0) {
+        sendError(response, "Timer pool full");
+        return;
+    }
+    if (!_relayController.turnOn(relayNum)) {
+        _relayTimers.cancel(id);
+        sendError(response, "Invalid relay number (1-16)");
+        return;
+    }
+    
+    // The auto-off replaces any other pending action of this relay
+    _relayTimers.cancelRelay(relayNum, id);
+    
+    JsonDocument data;
+    data["id"] = id;
+    data["duration"] = duration;
+    sendSuccess(response, data, "Relay turned ON with auto-off");
+    Serial.printf("Relay %d: ON for %u s\n", relayNum, duration);
+}
+
+void CommandHandler::handleTimerCancel(JsonDocument& doc, JsonDocument& response) {
+    JsonDocument data;
+    
+    if (doc.containsKey("id")) {
+        uint32_t id = doc["id"];
+        if (!_relayTimers.cancel(id)) {
+            sendError(response, "Unknown timer");
+            return;
+        }
+        data["id"] = id;
+    } else if (doc.containsKey("relay")) {
+        int relayNum = doc["relay"] | 0;
+        int cancelled = _relayTimers.cancelRelay(relayNum);
+        if (cancelled == 0) {
+            sendError(response, "No timers for this relay");
+            return;
+        }
+        data["relay"] = relayNum;
+        data["cancelled"] = cancelled;
+    } else {
+        sendError(response, "Missing 'id' or 'relay'");
+        return;
+    }
+    
+    sendSuccess(response, data, "Timer cancelled");
+}
+
+void CommandHandler::handleTimerList(JsonDocument& response) {
+    RelayTimerInfo timers[RelayTimerWheel::POOL_SIZE];
+    int count = _relayTimers.list(timers, RelayTimerWheel::POOL_SIZE);
+    uint32_t now = _historyStore.now();
+    
+    JsonDocument data;
+    JsonArray list = data["timers"].to<JsonArray>();
+    for (int i = 0; i < count; i++) {
+        JsonObject timer = list.add<JsonObject>();
+        timer["id"] = timers[i].id;
+        timer["relay"] = timers[i].relay;
+        timer["action"] = timerActionToString(timers[i].action);
+        timer["remaining"] = timers[i].expiry > now ? timers[i].expiry - now : 0;
+    }
+    
+    sendSuccess(response, data, "Active timers");
+}
+
+// ============================================================================
+// METRICS COMMAND HANDLERS
+// ============================================================================
+
+static void addLatency(JsonObject entry, const VanSight::LatencyHistogram& histogram) {
+    entry["n"] = histogram.getCount();
+    entry["p50"] = histogram.percentile(50);
+    entry["p99"] = histogram.percentile(99);
+    entry["max"] = histogram.getMax();
+}
+
+void CommandHandler::handleMetrics(JsonDocument& doc, JsonDocument& response) {
+    VanSight::LatencyMetrics& metrics = VanSight::LatencyMetrics::getInstance();
+    JsonDocument data;
+    data["unit"] = "us";
+    
+    const char* typeName = doc["type"];
+    if (typeName) {
+        // Every hub stage of one command type
+        VanSight::CommandType type = VanSight::stringToCommandType(typeName);
+        VanSight::LatencyHistogram histogram;
+        if (!metrics.getHistogram(type, VanSight::STAGE_HANDLER_END, histogram)) {
+            sendError(response, "Unknown command type");
+            return;
+        }
+        
+        data["type"] = typeName;
+        JsonArray stages = data["stages"].to<JsonArray>();
+        for (int s = VanSight::STAGE_HANDLER_START; s <= VanSight::STAGE_HUB_TX; s++) {
+            metrics.getHistogram(type, (VanSight::LatencyStage)s, histogram);
+            JsonObject stage = stages.add<JsonObject>();
+            stage["stage"] = VanSight::LatencyMetrics::stageName((VanSight::LatencyStage)s);
+            addLatency(stage, histogram);
+        }
+    } else {
+        // RX to handler end of every command type seen so far
+        JsonArray commands = data["commands"].to<JsonArray>();
+        for (int i = 0; i < VanSight::LatencyMetrics::COMMAND_SLOTS; i++) {
+            VanSight::LatencyHistogram histogram;
+            metrics.getHistogram((VanSight::CommandType)i, VanSight::STAGE_HANDLER_END, histogram);
+            if (histogram.getCount() == 0) {
+                continue;
+            }
+            JsonObject entry = commands.add<JsonObject>();
+            entry["type"] = VanSight::commandTypeToString((VanSight::CommandType)i);
+            addLatency(entry, histogram);
+        }
+    }
+    
+    if (doc["reset"] | false) {
+        metrics.reset();
+    }
+    
+    sendSuccess(response, data, "Latency since hub RX");
+}
+
+void CommandHandler::handleTelemetry(JsonDocument& response) {
+    JsonDocument data;
+    VanSight::Telemetry::getInstance().toJson(data.to<JsonObject>());
+    RateLimiter::getInstance().toJson(data["rate_limit"].to<JsonObject>());
+    CommandExecutor::getInstance().toJson(data["executor"].to<JsonObject>());
+    sendSuccess(response, data, "Resource telemetry");
+}
+
 // ============================================================================
 // HELPER METHODS
 // ============================================================================
@@ -3,13 +3,20 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include <VanSightLib.h>
 #include "RelayController.h"
 #include "SensorController.h"
+#include "StatusStore.h"
+#include "HistoryStore.h"
+#include "SceneStore.h"
+#include "RelayTimerWheel.h"
+#include "RateLimiter.h"
 
 /**
- * @brief CommandHandler class for processing ESP-NOW commands
+ * @brief CommandHandler class implementing the hub's command set
  * 
  * This class handles all incoming commands and generates appropriate responses.
+ * Status commands are answered from the StatusStore, never from the ADC.
  */
 class CommandHandler {
 public:
@@ -18,8 +25,21 @@ public:
      * 
      * @param relayCtrl Reference to RelayController
      * @param sensorCtrl Reference to SensorController
+     * @param statusStore Reference to StatusStore holding the latest readings
+     * @param historyStore Reference to HistoryStore for history queries
+     * @param sceneStore Reference to SceneStore holding relay scenes
+     * @param relayTimers Reference to RelayTimerWheel for scheduled actions
      */
-    CommandHandler(RelayController& relayCtrl, SensorController& sensorCtrl);
+    CommandHandler(RelayController& relayCtrl, SensorController& sensorCtrl, StatusStore& statusStore,
+                   HistoryStore& historyStore, SceneStore& sceneStore, RelayTimerWheel& relayTimers);
+    
+    /**
+     * @brief Register every command handler in the registry
+     * 
+     * All transports (BLE, ESP-NOW, WebSocket) dispatch into the registry,
+     * so each command is implemented once and reachable from all of them.
+     */
+    void registerCommands(VanSight::CommandRegistry& registry);
     
     /**
      * @brief Process a command and generate response
@@ -27,18 +47,25 @@ public:
      * @param data Command data (JSON)
      * @param len Data length
      * @param response Response document to populate
-     * @return true if command was valid, false otherwise
+     * @param peer Sender for rate limiting (RateLimiter::peerId, 0 = not limited)
+     * @return true if command was valid and admitted, false otherwise
      */
-    bool processCommand(const uint8_t* data, int len, JsonDocument& response);
+    bool processCommand(const uint8_t* data, int len, JsonDocument& response, uint32_t peer = 0);
 
 private:
     RelayController& _relayController;
     SensorController& _sensorController;
+    StatusStore& _statusStore;
+    HistoryStore& _historyStore;
+    SceneStore& _sceneStore;
+    RelayTimerWheel& _relayTimers;
     
     // Command handlers
     void handleRelayOn(JsonDocument& doc, JsonDocument& response);
     void handleRelayOff(JsonDocument& doc, JsonDocument& response);
     void handleRelayToggle(JsonDocument& doc, JsonDocument& response);
+    void handleRelaySet(JsonDocument& doc, JsonDocument& response);
+    void handleRelaysSet(JsonDocument& doc, JsonDocument& response);
     void handleRelayStatus(JsonDocument& doc, JsonDocument& response);
     void handleAllRelaysOn(JsonDocument& response);
     void handleAllRelaysOff(JsonDocument& response);
@@ -46,6 +73,21 @@ private:
     void handleSensorStatus(JsonDocument& doc, JsonDocument& response);
     void handleAllSensorStatus(JsonDocument& response);
     void handleAllStatus(JsonDocument& response);
+    void handleCalibratePoint(JsonDocument& doc, JsonDocument& response);
+    void handleCalibrateClear(JsonDocument& doc, JsonDocument& response);
+    void handleCalibrationStatus(JsonDocument& doc, JsonDocument& response);
+    void handleSensorHistory(JsonDocument& doc, JsonDocument& response);
+    void handleRelayHistory(JsonDocument& doc, JsonDocument& response);
+    void handleSceneSave(JsonDocument& doc, JsonDocument& response);
+    void handleSceneApply(JsonDocument& doc, JsonDocument& response);
+    void handleSceneDelete(JsonDocument& doc, JsonDocument& response);
+    void handleSceneList(JsonDocument& response);
+    void handleTimerAdd(JsonDocument& doc, JsonDocument& response);
+    void handleRelayPulse(JsonDocument& doc, JsonDocument& response);
+    void handleTimerCancel(JsonDocument& doc, JsonDocument& response);
+    void handleTimerList(JsonDocument& response);
+    void handleMetrics(JsonDocument& doc, JsonDocument& response);
+    void handleTelemetry(JsonDocument& response);
     
     // Helper methods
     void sendSuccess(JsonDocument& response, JsonDocument& data, const char* message = "");
@@ -0,0 +1,374 @@
+#include "HistoryStore.h"
+#include "config.h"
+#include <LittleFS.h>
+#include <Preferences.h>
+#include <esp_timer.h>
+
+using namespace VanSight;
+
+// Append-only segments; when a segment is full it becomes the .old segment
+static const char* SEGMENT_PATHS[TIER_COUNT] = { nullptr, "/history/minute.seg", "/history/hour.seg" };
+static const char* RELAY_SEGMENT_PATH = "/history/relay.seg";
+
+// How often the hub clock is written to NVS
+#define CLOCK_SAVE_INTERVAL_S 600
+
+HistoryStore::HistoryStore(int sensorCount)
+    : _sensorCount(min(sensorCount, MAX_SENSORS)),
+      _persistent(false),
+      _relayHead(0),
+      _relayCount(0),
+      _relayUnsaved(0),
+      _clockBase(0),
+      _clockStart(0),
+      _lastClockSave(0),
+      _mutex(nullptr) {
+    const uint16_t capacities[TIER_COUNT] = { HISTORY_FULL_POINTS, HISTORY_MINUTE_POINTS, HISTORY_HOUR_POINTS };
+    for (int t = 0; t < TIER_COUNT; t++) {
+        _rings[t].records = new HistoryRecord[capacities[t]];
+        _rings[t].capacity = capacities[t];
+        _rings[t].head = 0;
+        _rings[t].count = 0;
+        resetBucket(_buckets[t], 0);
+    }
+}
+
+bool HistoryStore::begin() {
+    if (!_mutex) {
+        _mutex = xSemaphoreCreateMutex();
+    }
+    
+    // Restore the clock from NVS
+    Preferences prefs;
+    uint32_t saved = 0;
+    if (prefs.begin("history", true)) {
+        saved = prefs.getUInt("clock", 0);
+        prefs.end();
+    }
+    
+    _persistent = LittleFS.begin(true);
+    if (_persistent) {
+        LittleFS.mkdir("/history");
+        
+        // Never go back behind persisted data
+        for (int t = TIER_MINUTE; t < TIER_COUNT; t++) {
+            uint32_t last = loadSegments((HistoryTier)t);
+            saved = max(saved, last + tierInterval((HistoryTier)t));
+        }
+        uint32_t lastRelay = loadRelaySegments();
+        saved = max(saved, lastRelay + 1);
+    } else {
+        Serial.println("[History] LittleFS mount failed, history is RAM only");
+    }
+    
+    _clockBase = saved;
+    _clockStart = esp_timer_get_time();
+    saveClock();
+    
+    Serial.printf("[History] Clock %u s, %u minute / %u hour records\n",
+                  now(), _rings[TIER_MINUTE].count, _rings[TIER_HOUR].count);
+    return _persistent;
+}
+
+uint32_t HistoryStore::now() const {
+    return _clockBase + (uint32_t)((esp_timer_get_time() - _clockStart) / 1000000);
+}
+
+void HistoryStore::lock() const {
+    if (_mutex) {
+        xSemaphoreTake(_mutex, portMAX_DELAY);
+    }
+}
+
+void HistoryStore::unlock() const {
+    if (_mutex) {
+        xSemaphoreGive(_mutex);
+    }
+}
+
+// ============================================================================
+// RING
+// ============================================================================
+
+void HistoryStore::Ring::push(const HistoryRecord& record) {
+    records[head] = record;
+    head = (head + 1) % capacity;
+    if (count < capacity) {
+        count++;
+    }
+}
+
+const HistoryRecord& HistoryStore::Ring::at(uint16_t index) const {
+    uint16_t oldest = (head + capacity - count) % capacity;
+    return records[(oldest + index) % capacity];
+}
+
+// ============================================================================
+// RECORDING
+// ============================================================================
+
+uint32_t HistoryStore::tierInterval(HistoryTier tier) {
+    switch (tier) {
+        case TIER_FULL:   return HISTORY_FULL_INTERVAL_S;
+        case TIER_MINUTE: return 60;
+        case TIER_HOUR:   return 3600;
+        default:          return 1;
+    }
+}
+
+void HistoryStore::resetBucket(Bucket& bucket, uint32_t start) {
+    bucket.start = start;
+    bucket.samples = 0;
+    for (int i = 0; i < MAX_SENSORS; i++) {
+        bucket.sums[i] = 0;
+        bucket.counts[i] = 0;
+    }
+}
+
+void HistoryStore::closeBucket(HistoryTier tier) {
+    Bucket& bucket = _buckets[tier];
+    if (bucket.samples == 0) {
+        return;
+    }
+    
+    HistoryRecord record;
+    record.time = bucket.start;
+    record.samples = min((int)bucket.samples, 255);
+    for (int i = 0; i < MAX_SENSORS; i++) {
+        record.levels[i] = bucket.counts[i] > 0
+            ? (uint8_t)((bucket.sums[i] + bucket.counts[i] / 2) / bucket.counts[i])
+            : HISTORY_NO_DATA;
+    }
+    
+    _rings[tier].push(record);
+    if (_persistent && SEGMENT_PATHS[tier]) {
+        appendSegment(SEGMENT_PATHS[tier], &record, sizeof(record), 1, _rings[tier].capacity);
+    }
+}
+
+void HistoryStore::recordLevels(const int levels[]) {
+    uint32_t t = now();
+    
+    lock();
+    for (int tier = 0; tier < TIER_COUNT; tier++) {
+        Bucket& bucket = _buckets[tier];
+        uint32_t interval = tierInterval((HistoryTier)tier);
+        
+        if (bucket.samples == 0 || t >= bucket.start + interval) {
+            closeBucket((HistoryTier)tier);
+            resetBucket(bucket, t - t % interval);
+        }
+        
+        for (int i = 0; i < _sensorCount; i++) {
+            if (levels[i] >= 0) {
+                bucket.sums[i] += levels[i];
+                bucket.counts[i]++;
+            }
+        }
+        if (bucket.samples < 0xFFFF) {
+            bucket.samples++;
+        }
+    }
+    unlock();
+    
+    if (t - _lastClockSave >= CLOCK_SAVE_INTERVAL_S) {
+        saveClock();
+    }
+}
+
+void HistoryStore::pushRelayEvent(const RelayEvent& event) {
+    _relayEvents[_relayHead] = event;
+    _relayHead = (_relayHead + 1) % RELAY_EVENT_CAPACITY;
+    if (_relayCount < RELAY_EVENT_CAPACITY) {
+        _relayCount++;
+    }
+}
+
+void HistoryStore::recordRelays(RelayMask mask) {
+    RelayEvent event;
+    event.time = now();
+    event.mask = mask;
+    
+    lock();
+    pushRelayEvent(event);
+    if (_persistent && _relayUnsaved < RELAY_EVENT_CAPACITY) {
+        _relayUnsaved++;
+    }
+    unlock();
+}
+
+void HistoryStore::flushRelays() {
+    RelayEvent pending[RELAY_EVENT_CAPACITY];
+    
+    lock();
+    uint16_t count = _relayUnsaved;
+    for (uint16_t i = 0; i < count; i++) {
+        pending[i] = _relayEvents[(_relayHead + RELAY_EVENT_CAPACITY - count + i) % RELAY_EVENT_CAPACITY];
+    }
+    _relayUnsaved = 0;
+    unlock();
+    
+    // Only this task writes the relay segment; recording goes on meanwhile
+    if (count > 0) {
+        appendSegment(RELAY_SEGMENT_PATH, pending, sizeof(RelayEvent), count, RELAY_EVENT_CAPACITY);
+    }
+}
+
+// ============================================================================
+// QUERIES
+// ============================================================================
+
+int HistoryStore::querySensor(int sensorNum, uint32_t from, uint32_t to, uint16_t points, int16_t out[], uint32_t& step) {
+    if (sensorNum < 1 || sensorNum > _sensorCount) return -1;
+    if (to <= from || points == 0) return 0;
+    points = min(points, MAX_QUERY_POINTS);
+    
+    lock();
+    
+    // Finest tier that reaches back to the start of the range,
+    // otherwise the one that reaches back furthest
+    int tier = TIER_HOUR;
+    uint32_t oldest = UINT32_MAX;
+    for (int t = TIER_FULL; t < TIER_COUNT; t++) {
+        const Ring& ring = _rings[t];
+        if (ring.count == 0) continue;
+        if (ring.at(0).time <= from) {
+            tier = t;
+            break;
+        }
+        if (ring.at(0).time < oldest) {
+            oldest = ring.at(0).time;
+            tier = t;
+        }
+    }
+    
+    uint32_t interval = tierInterval((HistoryTier)tier);
+    step = (to - from + points - 1) / points;
+    if (step < interval) {
+        step = interval;
+    }
+    int count = (to - from + step - 1) / step;
+    
+    uint32_t sums[MAX_QUERY_POINTS] = {0};
+    uint16_t counts[MAX_QUERY_POINTS] = {0};
+    
+    const Ring& ring = _rings[tier];
+    for (uint16_t i = 0; i < ring.count; i++) {
+        const HistoryRecord& record = ring.at(i);
+        if (record.time < from || record.time >= to) continue;
+        
+        uint8_t level = record.levels[sensorNum - 1];
+        if (level == HISTORY_NO_DATA) continue;
+        
+        int bin = (record.time - from) / step;
+        sums[bin] += level;
+        counts[bin]++;
+    }
+    
+    unlock();
+    
+    for (int i = 0; i < count; i++) {
+        out[i] = counts[i] > 0 ? (int16_t)((sums[i] + counts[i] / 2) / counts[i]) : -1;
+    }
+    return count;
+}
+
+int HistoryStore::queryRelays(uint32_t from, uint32_t to, RelayEvent out[], int max) {
+    if (max <= 0) return 0;
+    
+    lock();
+    
+    // Walk newest to oldest so the newest events are kept
+    int found = 0;
+    for (int i = _relayCount - 1; i >= 0 && found < max; i--) {
+        const RelayEvent& event = _relayEvents[(_relayHead + RELAY_EVENT_CAPACITY - _relayCount + i) % RELAY_EVENT_CAPACITY];
+        if (event.time >= from && event.time < to) {
+            out[found++] = event;
+        }
+    }
+    
+    unlock();
+    
+    // Oldest first
+    for (int i = 0; i < found / 2; i++) {
+        RelayEvent tmp = out[i];
+        out[i] = out[found - 1 - i];
+        out[found - 1 - i] = tmp;
+    }
+    return found;
+}
+
+// ============================================================================
+// PERSISTENCE
+// ============================================================================
+
+void HistoryStore::appendSegment(const char* path, const void* records, size_t size, uint16_t count, uint16_t capacity) {
+    File file = LittleFS.open(path, FILE_APPEND);
+    if (!file) {
+        return;
+    }
+    
+    file.write((const uint8_t*)records, size * count);
+    size_t length = file.size();
+    file.close();
+    
+    // Rotate: the full segment becomes .old, the previous .old is dropped
+    if (length >= capacity * size) {
+        char oldPath[40];
+        snprintf(oldPath, sizeof(oldPath), "%s.old", path);
+        LittleFS.remove(oldPath);
+        LittleFS.rename(path, oldPath);
+    }
+}
+
+uint32_t HistoryStore::loadSegments(HistoryTier tier) {
+    uint32_t last = 0;
+    char oldPath[40];
+    snprintf(oldPath, sizeof(oldPath), "%s.old", SEGMENT_PATHS[tier]);
+    const char* paths[2] = { oldPath, SEGMENT_PATHS[tier] };
+    
+    for (int p = 0; p < 2; p++) {
+        File file = LittleFS.open(paths[p], FILE_READ);
+        if (!file) continue;
+        
+        HistoryRecord record;
+        while (file.read((uint8_t*)&record, sizeof(record)) == sizeof(record)) {
+            _rings[tier].push(record);
+            last = max(last, record.time);
+        }
+        file.close();
+    }
+    
+    return last;
+}
+
+uint32_t HistoryStore::loadRelaySegments() {
+    uint32_t last = 0;
+    char oldPath[40];
+    snprintf(oldPath, sizeof(oldPath), "%s.old", RELAY_SEGMENT_PATH);
+    const char* paths[2] = { oldPath, RELAY_SEGMENT_PATH };
+    
+    for (int p = 0; p < 2; p++) {
+        File file = LittleFS.open(paths[p], FILE_READ);
+        if (!file) continue;
+        
+        RelayEvent event;
+        while (file.read((uint8_t*)&event, sizeof(event)) == sizeof(event)) {
+            pushRelayEvent(event);
+            last = max(last, event.time);
+        }
+        file.close();
+    }
+    
+    return last;
+}
+
+void HistoryStore::saveClock() {
+    uint32_t t = now();
+    Preferences prefs;
+    if (prefs.begin("history", false)) {
+        prefs.putUInt("clock", t);
+        prefs.end();
+    }
+    _lastClockSave = t;
+}
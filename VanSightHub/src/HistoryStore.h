@@ -0,0 +1,162 @@
+#ifndef HISTORY_STORE_H
+#define HISTORY_STORE_H
+
+#include <Arduino.h>
+#include <VanSightLib.h>
+
+/**
+ * @brief One aggregated sample of all sensors
+ */
+struct HistoryRecord {
+    uint32_t time;                              // Hub clock seconds (bucket start)
+    uint8_t levels[VanSight::MAX_SENSORS];      // Level %, HISTORY_NO_DATA if missing
+    uint8_t samples;                            // Samples averaged (saturates at 255)
+};
+
+/**
+ * @brief Relay mask after a change
+ */
+struct RelayEvent {
+    uint32_t time;
+    VanSight::RelayMask mask;
+};
+
+/**
+ * @brief Resolution tiers of the sensor history
+ */
+enum HistoryTier {
+    TIER_FULL = 0,   // HISTORY_FULL_INTERVAL_S buckets, RAM only
+    TIER_MINUTE,     // 1 minute buckets, persisted
+    TIER_HOUR,       // 1 hour buckets, persisted
+    TIER_COUNT
+};
+
+#define HISTORY_NO_DATA 0xFF
+
+/**
+ * @brief Ring-buffered sensor and relay history
+ *
+ * Sensor levels are averaged into full-resolution, minute and hour
+ * buckets, each kept in a fixed ring. Closed minute and hour buckets are
+ * appended to LittleFS segments and reloaded at boot. Relay events are
+ * only kept in RAM when recorded and written out in batches by
+ * flushRelays(). Time is a hub clock
+ * in seconds that is persisted in NVS, so it keeps increasing across
+ * reboots (it does not count time spent powered off).
+ *
+ * Queries pick the finest tier that covers the range and downsample it
+ * into a fixed number of points.
+ */
+class HistoryStore {
+public:
+    static const uint16_t MAX_QUERY_POINTS = 120;
+    
+    /**
+     * @brief Construct a new History Store object
+     *
+     * @param sensorCount Number of sensors (max VanSight::MAX_SENSORS)
+     */
+    HistoryStore(int sensorCount);
+    
+    /**
+     * @brief Mount LittleFS, restore the clock and load persisted segments
+     *
+     * @return true if persistence is available
+     */
+    bool begin();
+    
+    /**
+     * @brief Get the hub clock in seconds
+     */
+    uint32_t now() const;
+    
+    /**
+     * @brief Add the current level of every sensor (call on every poll)
+     *
+     * @param levels Level percentages, negative if not sampled yet
+     */
+    void recordLevels(const int levels[]);
+    
+    /**
+     * @brief Record a relay mask change (RAM only, cheap on the command path)
+     */
+    void recordRelays(VanSight::RelayMask mask);
+    
+    /**
+     * @brief Append the relay events recorded since the last flush to LittleFS
+     *
+     * Call periodically from the loop task.
+     */
+    void flushRelays();
+    
+    /**
+     * @brief Downsample one sensor's history
+     *
+     * @param sensorNum Sensor number (1-based index)
+     * @param from Range start (hub clock seconds, inclusive)
+     * @param to Range end (hub clock seconds, exclusive)
+     * @param points Maximum number of points (max MAX_QUERY_POINTS)
+     * @param out Receives one level per point, -1 where there is no data
+     * @param step Receives the seconds covered by each point
+     * @return int Number of points written, -1 if invalid sensor
+     */
+    int querySensor(int sensorNum, uint32_t from, uint32_t to, uint16_t points, int16_t out[], uint32_t& step);
+    
+    /**
+     * @brief Get relay events in a range (newest last)
+     *
+     * @param out Receives up to max events; the newest are kept if more match
+     * @return int Number of events written
+     */
+    int queryRelays(uint32_t from, uint32_t to, RelayEvent out[], int max);
+    
+private:
+    struct Ring {
+        HistoryRecord* records;
+        uint16_t capacity;
+        uint16_t head;      // Next write position
+        uint16_t count;
+        
+        void push(const HistoryRecord& record);
+        const HistoryRecord& at(uint16_t index) const;  // 0 = oldest
+    };
+    
+    struct Bucket {
+        uint32_t start;
+        uint32_t sums[VanSight::MAX_SENSORS];
+        uint16_t counts[VanSight::MAX_SENSORS];
+        uint16_t samples;
+    };
+    
+    int _sensorCount;
+    bool _persistent;
+    
+    Ring _rings[TIER_COUNT];
+    Bucket _buckets[TIER_COUNT];
+    
+    static const uint16_t RELAY_EVENT_CAPACITY = 64;
+    RelayEvent _relayEvents[RELAY_EVENT_CAPACITY];
+    uint16_t _relayHead;
+    uint16_t _relayCount;
+    uint16_t _relayUnsaved;     // Newest events not yet on LittleFS
+    
+    uint32_t _clockBase;        // Clock value at _clockStart
+    int64_t _clockStart;        // esp_timer time (us) when the clock was restored
+    uint32_t _lastClockSave;
+    
+    SemaphoreHandle_t _mutex;
+    
+    static uint32_t tierInterval(HistoryTier tier);
+    void resetBucket(Bucket& bucket, uint32_t start);
+    void closeBucket(HistoryTier tier);
+    void pushRelayEvent(const RelayEvent& event);
+    void appendSegment(const char* path, const void* records, size_t size, uint16_t count, uint16_t capacity);
+    uint32_t loadSegments(HistoryTier tier);
+    uint32_t loadRelaySegments();
+    void saveClock();
+    
+    void lock() const;
+    void unlock() const;
+};
+
+#endif // HISTORY_STORE_H
@@ -0,0 +1,120 @@
+#include "HubScheduler.h"
+#include <esp_timer.h>
+
+HubScheduler::HubScheduler()
+    : _jobCount(0),
+      _pending(0),
+      _task(nullptr) {
+}
+
+void HubScheduler::begin() {
+    _task = xTaskGetCurrentTaskHandle();
+}
+
+int HubScheduler::addJob(const char* name, std::function<void()> job, uint32_t periodMs,
+                         EventBits events, uint32_t minIntervalMs) {
+    if (_jobCount >= MAX_JOBS) {
+        return -1;
+    }
+    
+    Job& entry = _jobs[_jobCount];
+    entry.name = name;
+    entry.run = job;
+    entry.periodMs = periodMs;
+    entry.events = events;
+    entry.minIntervalMs = minIntervalMs;
+    entry.lastRun = millis();
+    entry.runs = 0;
+    entry.maxRunUs = 0;
+    _printedMaxUs[_jobCount] = 0;
+    return _jobCount++;
+}
+
+void HubScheduler::signal(EventBits events) {
+    if (_task) {
+        xTaskNotify(_task, events, eSetBits);
+    }
+}
+
+uint32_t HubScheduler::nextWait(uint32_t now, uint32_t maxWaitMs) const {
+    uint32_t wait = maxWaitMs;
+    
+    for (int i = 0; i < _jobCount; i++) {
+        const Job& job = _jobs[i];
+        uint32_t elapsed = now - job.lastRun;
+        
+        if (job.periodMs > 0) {
+            wait = min(wait, elapsed >= job.periodMs ? 0 : job.periodMs - elapsed);
+        }
+        // Event already pending but held back by the minimum interval
+        if (job.events & _pending) {
+            wait = min(wait, elapsed >= job.minIntervalMs ? 0 : job.minIntervalMs - elapsed);
+        }
+    }
+    
+    return wait;
+}
+
+void HubScheduler::runOnce(uint32_t maxWaitMs) {
+    uint32_t wait = nextWait(millis(), maxWaitMs);
+    
+    uint32_t bits = 0;
+    if (xTaskNotifyWait(0, 0xFFFFFFFF, &bits, pdMS_TO_TICKS(wait)) == pdTRUE) {
+        _pending |= bits;
+    }
+    
+    EventBits consumed = 0;
+    for (int i = 0; i < _jobCount; i++) {
+        Job& job = _jobs[i];
+        uint32_t now = millis();
+        uint32_t elapsed = now - job.lastRun;
+        
+        bool timeDue = job.periodMs > 0 && elapsed >= job.periodMs;
+        bool eventDue = (job.events & _pending) && elapsed >= job.minIntervalMs;
+        if (!timeDue && !eventDue) {
+            continue;
+        }
+        
+        consumed |= job.events & _pending;
+        job.lastRun = now;
+        
+        int64_t start = esp_timer_get_time();
+        job.run();
+        uint32_t runUs = (uint32_t)(esp_timer_get_time() - start);
+        
+        job.runs++;
+        if (runUs > job.maxRunUs) {
+            job.maxRunUs = runUs;
+        }
+    }
+    
+    _pending &= ~consumed;
+}
+
+HubScheduler::JobStats HubScheduler::getStats(int index) const {
+    JobStats stats = { "", 0, 0 };
+    if (index >= 0 && index < _jobCount) {
+        stats.name = _jobs[index].name;
+        stats.runs = _jobs[index].runs;
+        stats.maxRunUs = _jobs[index].maxRunUs;
+    }
+    return stats;
+}
+
+void HubScheduler::printStats() {
+    bool slower = false;
+    for (int i = 0; i < _jobCount; i++) {
+        if (_jobs[i].maxRunUs > _printedMaxUs[i]) {
+            slower = true;
+        }
+    }
+    if (!slower) {
+        return;
+    }
+    
+    for (int i = 0; i < _jobCount; i++) {
+        JobStats stats = getStats(i);
+        _printedMaxUs[i] = stats.maxRunUs;
+        Serial.printf("[Scheduler] %s: %u runs, max %u us\n", stats.name, stats.runs, stats.maxRunUs);
+    }
+}
@@ -0,0 +1,95 @@
+#ifndef HUB_SCHEDULER_H
+#define HUB_SCHEDULER_H
+
+#include <Arduino.h>
+#include <functional>
+
+typedef uint32_t EventBits;
+
+/**
+ * @brief Cooperative scheduler for the hub loop
+ *
+ * Jobs run on the loop task, either periodically, when one of their
+ * events is signalled, or both. Between jobs the loop task blocks on its
+ * task notification until the next job is due or an event arrives, so it
+ * uses no CPU while idle and reacts to events without waiting for a poll.
+ */
+class HubScheduler {
+public:
+    static const uint8_t MAX_JOBS = 12;
+    
+    /**
+     * @brief Counters of one job
+     */
+    struct JobStats {
+        const char* name;
+        uint32_t runs;
+        uint32_t maxRunUs;
+    };
+    
+    HubScheduler();
+    
+    /**
+     * @brief Bind the scheduler to the calling task (call from setup)
+     */
+    void begin();
+    
+    /**
+     * @brief Add a job
+     *
+     * @param name Job name (static string)
+     * @param job Function to run
+     * @param periodMs Run every periodMs (0 = event-driven only)
+     * @param events Event bits that trigger the job (0 = periodic only)
+     * @param minIntervalMs Minimum time between event-triggered runs
+     * @return int Job index, -1 if the table is full
+     */
+    int addJob(const char* name, std::function<void()> job, uint32_t periodMs,
+               EventBits events = 0, uint32_t minIntervalMs = 0);
+    
+    /**
+     * @brief Signal events (safe from any task)
+     */
+    void signal(EventBits events);
+    
+    /**
+     * @brief Wait for the next due job or event and run what is due
+     *
+     * @param maxWaitMs Upper bound for the wait
+     */
+    void runOnce(uint32_t maxWaitMs = 1000);
+    
+    /**
+     * @brief Get counters of a job
+     */
+    JobStats getStats(int index) const;
+    
+    /**
+     * @brief Print run counts and worst run times once any job got slower
+     */
+    void printStats();
+    
+    int getJobCount() const { return _jobCount; }
+    
+private:
+    struct Job {
+        const char* name;
+        std::function<void()> run;
+        uint32_t periodMs;
+        EventBits events;
+        uint32_t minIntervalMs;
+        uint32_t lastRun;
+        uint32_t runs;
+        uint32_t maxRunUs;
+    };
+    
+    Job _jobs[MAX_JOBS];
+    int _jobCount;
+    uint32_t _printedMaxUs[MAX_JOBS];
+    EventBits _pending;
+    TaskHandle_t _task;
+    
+    uint32_t nextWait(uint32_t now, uint32_t maxWaitMs) const;
+};
+
+#endif // HUB_SCHEDULER_H
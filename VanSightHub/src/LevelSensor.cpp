@@ -21,17 +21,30 @@ int LevelSensor::readRaw() {
 }
 
 float LevelSensor::readVoltage() {
-    int adcValue = readRaw();
-    return (adcValue / (float)ADC_RESOLUTION) * SUPPLY_VOLTAGE;
+    return rawToVoltage(readRaw());
 }
 
 float LevelSensor::readResistance() {
-    int adcValue = readRaw();
-    float voltage = readVoltage();
-    
-    // DEBUG: Print raw values
-    Serial.printf("[Sensor Pin %d] ADC Raw: %d, Voltage: %.3fV, Ref: %.1fΩ\n", 
-                  _pin, adcValue, voltage, _referenceResistor);
+    // One sample feeds both voltage and resistance
+    return rawToResistance(readRaw());
+}
+
+int LevelSensor::readLevel() {
+    return rawToLevel(readRaw());
+}
+
+int LevelSensor::getAdcChannel() const {
+    int channel = digitalPinToAnalogChannel(_pin);
+    // Continuous sampling on the ESP32 is limited to ADC1 (channels 0-7)
+    return (channel >= 0 && channel < 8) ? channel : -1;
+}
+
+float LevelSensor::rawToVoltage(int raw) const {
+    return (raw / (float)ADC_RESOLUTION) * SUPPLY_VOLTAGE;
+}
+
+float LevelSensor::rawToResistance(int raw) const {
+    float voltage = rawToVoltage(raw);
     
     // Prevent division by zero
     if (voltage >= SUPPLY_VOLTAGE - 0.01) {
@@ -46,28 +59,21 @@ float LevelSensor::readResistance() {
         // Assuming pot is connected: 3.3V -- Pot -- ADC -- GND
         float ratio = voltage / SUPPLY_VOLTAGE;
         resistance = ratio * 10000.0; // 10K pot
-        Serial.printf("  -> Direct mode: Raw Resistance = %.1fΩ\n", resistance);
     } else {
         // Calculate resistance using voltage divider formula
         // Vout = Vin * (R_sensor / (R_ref + R_sensor))
         // Solving for R_sensor:
         // R_sensor = (Vout * R_ref) / (Vin - Vout)
         resistance = (voltage * _referenceResistor) / (SUPPLY_VOLTAGE - voltage);
-        Serial.printf("  -> Voltage divider mode: Raw Resistance = %.1fΩ\n", resistance);
     }
     
     // Apply calibration factor to correct for ADC non-linearity and component tolerances
     // Calibration: Measured 9360Ω when actual is 10000Ω -> factor = 10000/9360 = 1.068
     const float CALIBRATION_FACTOR = 1.068;
-    resistance = resistance * CALIBRATION_FACTOR;
-    
-    Serial.printf("  -> Calibrated Resistance = %.1fΩ\n", resistance);
-    return resistance;
+    return resistance * CALIBRATION_FACTOR;
 }
 
-int LevelSensor::readLevel() {
-    float resistance = readResistance();
-    
+int LevelSensor::resistanceToLevel(float resistance) const {
     // Convert resistance to percentage (0-100%)
     float level = ((resistance - _minResistance) / (_maxResistance - _minResistance)) * 100.0;
     
@@ -77,3 +83,28 @@ int LevelSensor::readLevel() {
     
     return (int)level;
 }
+
+int LevelSensor::rawToLevel(int raw) const {
+    if (_calibration.isValid()) {
+        // Permille -> percent, rounded
+        return (_calibration.lookup(raw) + 5) / 10;
+    }
+    
+    return resistanceToLevel(rawToResistance(raw));
+}
+
+void LevelSensor::setFilter(const FilterConfig& config) {
+    _filter.configure(config);
+}
+
+void LevelSensor::setChangeThresholds(uint8_t deadband, uint8_t hysteresis) {
+    _changeDetector.configure(deadband, hysteresis);
+}
+
+int LevelSensor::filter(int raw) {
+    return _filter.process(raw);
+}
+
+bool LevelSensor::updateLevel(int level) {
+    return _changeDetector.update(level);
+}
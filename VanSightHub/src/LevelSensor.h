@@ -2,6 +2,8 @@
 #define LEVEL_SENSOR_H
 
 #include <Arduino.h>
+#include "SensorFilter.h"
+#include "CalibrationTable.h"
 
 /**
  * @brief LevelSensor class for reading resistance-based level sensors
@@ -58,6 +60,89 @@ public:
      * @return float Voltage in volts
      */
     float readVoltage();
+    
+    /**
+     * @brief Get the ADC channel of the pin
+     * 
+     * @return int ADC1 channel (0-7), -1 if the pin is not on ADC1
+     */
+    int getAdcChannel() const;
+    
+    /**
+     * @brief Convert a raw ADC value to voltage
+     * 
+     * @param raw ADC value (0-4095)
+     * @return float Voltage in volts
+     */
+    float rawToVoltage(int raw) const;
+    
+    /**
+     * @brief Convert a raw ADC value to resistance
+     * 
+     * @param raw ADC value (0-4095)
+     * @return float Resistance in ohms
+     */
+    float rawToResistance(int raw) const;
+    
+    /**
+     * @brief Convert a resistance to level percentage
+     * 
+     * @param resistance Resistance in ohms
+     * @return int Level percentage (0-100)
+     */
+    int resistanceToLevel(float resistance) const;
+    
+    /**
+     * @brief Convert a raw ADC value to level percentage
+     * 
+     * Uses the calibration table when it has at least two points,
+     * otherwise the resistance min/max mapping.
+     * 
+     * @param raw ADC value (0-4095)
+     * @return int Level percentage (0-100)
+     */
+    int rawToLevel(int raw) const;
+    
+    /**
+     * @brief Get the calibration table
+     */
+    CalibrationTable& getCalibration() { return _calibration; }
+    
+    /**
+     * @brief Configure the filter chain applied to raw ADC values
+     */
+    void setFilter(const FilterConfig& config);
+    
+    /**
+     * @brief Configure when a level change is reported
+     * 
+     * @param deadband Minimum level change (%) that is reported
+     * @param hysteresis Extra change (%) needed to reverse direction
+     */
+    void setChangeThresholds(uint8_t deadband, uint8_t hysteresis);
+    
+    /**
+     * @brief Run one raw ADC value through the filter chain
+     * 
+     * @param raw ADC value (0-4095)
+     * @return int Filtered ADC value
+     */
+    int filter(int raw);
+    
+    /**
+     * @brief Feed a level into the change detector
+     * 
+     * @param level Level percentage (0-100)
+     * @return true if the reported level changed
+     */
+    bool updateLevel(int level);
+    
+    /**
+     * @brief Get the last reported (stable) level
+     * 
+     * @return int Level percentage, -1 before the first update
+     */
+    int getReportedLevel() const { return _changeDetector.getReported(); }
 
 private:
     uint8_t _pin;
@@ -65,6 +150,10 @@ private:
     float _maxResistance;
     float _referenceResistor;
     
+    SensorFilter _filter;
+    ChangeDetector _changeDetector;
+    CalibrationTable _calibration;
+    
     static const int ADC_RESOLUTION = 4095;  // 12-bit ADC
     static constexpr float SUPPLY_VOLTAGE = 3.3;  // ESP32 ADC reference voltage
 };
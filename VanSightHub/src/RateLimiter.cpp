@@ -0,0 +1,159 @@
+#include "RateLimiter.h"
+
+using namespace VanSight;
+
+RateLimiter::RateLimiter()
+    : _mux(portMUX_INITIALIZER_UNLOCKED) {
+    for (int l = 0; l < LANE_COUNT; l++) {
+        _limits[l].perSecond = 0;
+        _limits[l].burst = 0;
+        _stats[l].allowed = 0;
+        _stats[l].limited = 0;
+    }
+    memset(_peers, 0, sizeof(_peers));
+}
+
+void RateLimiter::setLimit(CommandLane lane, const RateLimit& limit) {
+    if (lane >= LANE_COUNT) return;
+    
+    portENTER_CRITICAL(&_mux);
+    _limits[lane] = limit;
+    // Restart every bucket of the lane full
+    for (int p = 0; p < MAX_PEERS; p++) {
+        _peers[p].buckets[lane].milliTokens = (uint32_t)limit.burst * 1000;
+    }
+    portEXIT_CRITICAL(&_mux);
+}
+
+// ============================================================================
+// ADMISSION
+// ============================================================================
+
+bool RateLimiter::allow(uint32_t peer, CommandType type, uint32_t& retryMs) {
+    CommandLane lane = CommandExecutor::laneFor(type);
+    retryMs = 0;
+    
+    portENTER_CRITICAL(&_mux);
+    const RateLimit& limit = _limits[lane];
+    
+    // Safety commands and unconfigured lanes always pass
+    if (lane == LANE_CRITICAL || limit.perSecond == 0) {
+        _stats[lane].allowed++;
+        portEXIT_CRITICAL(&_mux);
+        return true;
+    }
+    
+    uint32_t now = millis();
+    Peer& entry = findPeer(peer, now);
+    Bucket& bucket = entry.buckets[lane];
+    
+    // Refill: perSecond tokens per 1000 ms is perSecond milli-tokens per ms
+    uint32_t capacity = (uint32_t)limit.burst * 1000;
+    uint32_t elapsed = now - bucket.refilledMs;
+    uint32_t refill = min(elapsed, capacity) * limit.perSecond;
+    bucket.milliTokens = min(bucket.milliTokens + refill, capacity);
+    bucket.refilledMs = now;
+    
+    bool allowed = bucket.milliTokens >= 1000;
+    if (allowed) {
+        bucket.milliTokens -= 1000;
+        _stats[lane].allowed++;
+    } else {
+        retryMs = (1000 - bucket.milliTokens + limit.perSecond - 1) / limit.perSecond;
+        entry.limited++;
+        _stats[lane].limited++;
+    }
+    portEXIT_CRITICAL(&_mux);
+    
+    return allowed;
+}
+
+bool RateLimiter::admit(uint32_t peer, CommandType type, JsonDocument& response) {
+    uint32_t retryMs;
+    if (allow(peer, type, retryMs)) {
+        return true;
+    }
+    
+    Serial.printf("[RateLimit] Peer 0x%08X busy (%s)\n", peer, commandTypeToString(type));
+    response["status"] = "busy";
+    JsonObject data = response["data"].to<JsonObject>();
+    data["cmd"] = commandTypeToString(type);
+    data["retry_ms"] = retryMs;
+    response["message"] = "Too many commands, retry later";
+    return false;
+}
+
+RateLimiter::Peer& RateLimiter::findPeer(uint32_t id, uint32_t now) {
+    // Caller holds _mux
+    Peer* oldest = &_peers[0];
+    for (int p = 0; p < MAX_PEERS; p++) {
+        Peer& entry = _peers[p];
+        if (entry.id == id) {
+            entry.lastSeenMs = now;
+            return entry;
+        }
+        if (entry.id == 0) {
+            resetPeer(entry, id, now);
+            return entry;
+        }
+        if ((int32_t)(entry.lastSeenMs - oldest->lastSeenMs) < 0) {
+            oldest = &entry;
+        }
+    }
+    
+    resetPeer(*oldest, id, now);
+    return *oldest;
+}
+
+void RateLimiter::resetPeer(Peer& peer, uint32_t id, uint32_t now) {
+    peer.id = id;
+    peer.lastSeenMs = now;
+    peer.limited = 0;
+    for (int l = 0; l < LANE_COUNT; l++) {
+        peer.buckets[l].milliTokens = (uint32_t)_limits[l].burst * 1000;
+        peer.buckets[l].refilledMs = now;
+    }
+}
+
+// ============================================================================
+// REPORTING
+// ============================================================================
+
+RateLimitStats RateLimiter::getStats(CommandLane lane) const {
+    RateLimitStats stats = {0, 0};
+    if (lane >= LANE_COUNT) return stats;
+    
+    portENTER_CRITICAL(&_mux);
+    stats = _stats[lane];
+    portEXIT_CRITICAL(&_mux);
+    return stats;
+}
+
+void RateLimiter::toJson(JsonObject out) const {
+    RateLimitStats stats[LANE_COUNT];
+    Peer peers[MAX_PEERS];
+    
+    portENTER_CRITICAL(&_mux);
+    memcpy(stats, _stats, sizeof(stats));
+    memcpy(peers, _peers, sizeof(peers));
+    portEXIT_CRITICAL(&_mux);
+    
+    JsonArray lanes = out["lanes"].to<JsonArray>();
+    for (int l = 0; l < LANE_COUNT; l++) {
+        JsonObject lane = lanes.add<JsonObject>();
+        lane["lane"] = CommandExecutor::laneName((CommandLane)l);
+        lane["per_second"] = _limits[l].perSecond;
+        lane["burst"] = _limits[l].burst;
+        lane["allowed"] = stats[l].allowed;
+        lane["limited"] = stats[l].limited;
+    }
+    
+    JsonArray list = out["peers"].to<JsonArray>();
+    for (int p = 0; p < MAX_PEERS; p++) {
+        if (peers[p].id == 0) continue;
+        JsonObject peer = list.add<JsonObject>();
+        peer["id"] = peers[p].id;
+        peer["limited"] = peers[p].limited;
+        peer["idle_ms"] = millis() - peers[p].lastSeenMs;
+    }
+}
@@ -0,0 +1,123 @@
+#ifndef RATE_LIMITER_H
+#define RATE_LIMITER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <VanSightLib.h>
+#include "CommandExecutor.h"
+
+/**
+ * @brief Transports a peer id belongs to (top byte of the id)
+ */
+enum PeerTransport {
+    PEER_BLE = 1,
+    PEER_WEB,
+    PEER_ESPNOW
+};
+
+/**
+ * @brief Token bucket settings of one command lane
+ */
+struct RateLimit {
+    uint16_t perSecond;   // Sustained commands per second (0 = unlimited)
+    uint16_t burst;       // Commands accepted back to back
+};
+
+/**
+ * @brief Counters of one command lane
+ */
+struct RateLimitStats {
+    uint32_t allowed;
+    uint32_t limited;
+};
+
+/**
+ * @brief Per-peer, per-lane token bucket admission for incoming commands
+ *
+ * Every peer (BLE link, browser, ESP-NOW sender) has one bucket per
+ * executor lane, so a flooding client runs out of its own tokens and
+ * never delays the others. Limited commands are answered with a "busy"
+ * response before they reach GPIO, the buzzer or a broadcast.
+ *
+ * The critical lane (all relays off) is never limited. The peer table is
+ * fixed; when it is full the least recently seen peer is replaced.
+ * Safe to call from the BLE, WebSocket and loop tasks.
+ */
+class RateLimiter {
+public:
+    static const uint8_t MAX_PEERS = 8;
+    
+    /**
+     * @brief Get singleton instance
+     */
+    static RateLimiter& getInstance() {
+        static RateLimiter instance;
+        return instance;
+    }
+    
+    /**
+     * @brief Set the limit of a lane (call from setup)
+     */
+    void setLimit(CommandLane lane, const RateLimit& limit);
+    
+    /**
+     * @brief Take a token for a command
+     *
+     * @param peer Peer id (see peerId())
+     * @param type Command type, mapped to its executor lane
+     * @param retryMs Set to the wait until the next token when limited
+     * @return true if the command may run
+     */
+    bool allow(uint32_t peer, VanSight::CommandType type, uint32_t& retryMs);
+    
+    /**
+     * @brief Take a token, or fill a "busy" response
+     *
+     * @return true if the command may run; false if response was filled
+     */
+    bool admit(uint32_t peer, VanSight::CommandType type, JsonDocument& response);
+    
+    /**
+     * @brief Get a copy of a lane's counters
+     */
+    RateLimitStats getStats(CommandLane lane) const;
+    
+    /**
+     * @brief Add the lane counters and the known peers to a JSON object
+     */
+    void toJson(JsonObject out) const;
+    
+    /**
+     * @brief Build a peer id from a transport and a transport-local id
+     */
+    static uint32_t peerId(PeerTransport transport, uint32_t id) {
+        return ((uint32_t)transport << 24) | (id & 0xFFFFFF);
+    }
+
+private:
+    RateLimiter();
+    RateLimiter(const RateLimiter&) = delete;
+    RateLimiter& operator=(const RateLimiter&) = delete;
+    
+    struct Bucket {
+        uint32_t milliTokens;   // Tokens * 1000
+        uint32_t refilledMs;
+    };
+    
+    struct Peer {
+        uint32_t id;            // 0 = free slot
+        uint32_t lastSeenMs;
+        uint32_t limited;
+        Bucket buckets[LANE_COUNT];
+    };
+    
+    RateLimit _limits[LANE_COUNT];
+    Peer _peers[MAX_PEERS];
+    RateLimitStats _stats[LANE_COUNT];
+    mutable portMUX_TYPE _mux;
+    
+    Peer& findPeer(uint32_t id, uint32_t now);
+    void resetPeer(Peer& peer, uint32_t id, uint32_t now);
+};
+
+#endif // RATE_LIMITER_H
@@ -1,68 +1,94 @@
 #include "RelayController.h"
 
-RelayController::RelayController(const int* pins, int count) 
-    : _count(count) {
-    // Allocate array of SimpleRelay pointers
-    _relays = new SimpleRelay*[_count];
-    
-    // Create SimpleRelay objects for each pin
-    for (int i = 0; i < _count; i++) {
-        _relays[i] = new SimpleRelay(pins[i]);
-    }
+using namespace VanSight;
+
+static int clampCount(int count) {
+    return count < MAX_RELAYS ? count : MAX_RELAYS;
+}
+
+#ifdef ARDUINO
+RelayController::RelayController(const int* pins, int count, bool activeLow) 
+    : _output(new GpioRelayOutput(pins, clampCount(count), activeLow)),
+      _ownsOutput(true),
+      _count(clampCount(count)),
+      _state(0) {
+    _validMask = (_count >= 16) ? 0xFFFF : (RelayMask)((1u << _count) - 1);
+}
+#endif
+
+RelayController::RelayController(RelayOutput& output, int count)
+    : _output(&output),
+      _ownsOutput(false),
+      _count(clampCount(count)),
+      _state(0) {
+    _validMask = (_count >= 16) ? 0xFFFF : (RelayMask)((1u << _count) - 1);
 }
 
 RelayController::~RelayController() {
-    // Clean up all relay objects
-    for (int i = 0; i < _count; i++) {
-        delete _relays[i];
+    if (_ownsOutput) {
+        delete _output;
     }
-    delete[] _relays;
 }
 
-void RelayController::begin() {
-    // SimpleRelay handles initialization in constructor
-    // Nothing additional needed here
+void RelayController::begin(RelayMask initialMask) {
+    _state = initialMask & _validMask;
+    _output->begin(_state);
 }
 
 bool RelayController::isValidRelayNum(int relayNum) const {
     return (relayNum >= 1 && relayNum <= _count);
 }
 
+RelayMask RelayController::update(RelayMask clear, RelayMask set, RelayMask flip) {
+    // Read-modify-write from BLE, WebSocket and loop tasks
+    _lock.lock();
+    RelayMask before = _state;
+    RelayMask state = ((before & ~clear) | set) ^ flip;
+    _state = state & _validMask;
+    _output->write(_state);
+    _lock.unlock();
+    return before;
+}
+
 bool RelayController::turnOn(int relayNum) {
     if (!isValidRelayNum(relayNum)) return false;
     
-    _relays[relayNum - 1]->on();
+    update(0, relayBit(relayNum), 0);
     return true;
 }
 
 bool RelayController::turnOff(int relayNum) {
     if (!isValidRelayNum(relayNum)) return false;
     
-    _relays[relayNum - 1]->off();
+    update(relayBit(relayNum), 0, 0);
     return true;
 }
 
 bool RelayController::toggle(int relayNum) {
     if (!isValidRelayNum(relayNum)) return false;
     
-    _relays[relayNum - 1]->toggle();
+    update(0, 0, relayBit(relayNum));
     return true;
 }
 
 bool RelayController::getState(int relayNum) {
     if (!isValidRelayNum(relayNum)) return false;
     
-    return _relays[relayNum - 1]->isRelayOn();
+    return (_state & relayBit(relayNum)) != 0;
 }
 
 void RelayController::allOn() {
-    for (int i = 0; i < _count; i++) {
-        _relays[i]->on();
-    }
+    apply(_validMask);
 }
 
 void RelayController::allOff() {
-    for (int i = 0; i < _count; i++) {
-        _relays[i]->off();
-    }
+    apply(0);
+}
+
+void RelayController::apply(RelayMask mask) {
+    update(0xFFFF, mask, 0);
+}
+
+RelayMask RelayController::set(RelayMask mask, RelayMask values) {
+    return update(mask, values & mask, 0);
 }
@@ -1,14 +1,19 @@
 #ifndef RELAY_CONTROLLER_H
 #define RELAY_CONTROLLER_H
 
-#include <Arduino.h>
-#include <SimpleRelay.h>
+#include <stdint.h>
+#include <config/VanSightConfig.h>
+#include <protocol/VanSightProtocol.h>
+#include "RelayOutput.h"
+#include "SpinLock.h"
 
 /**
  * @brief RelayController class for managing multiple relays
  * 
  * This class provides a centralized interface for controlling
- * multiple relays with simple methods.
+ * multiple relays with simple methods. The relay state is kept as one
+ * mask and every change is written to the output backend in one step.
+ * Only the GPIO constructor needs the ESP32; the rest builds on the host.
  */
 class RelayController {
 public:
@@ -17,8 +22,19 @@ public:
      * 
      * @param pins Array of GPIO pins for relays
      * @param count Number of relays
+     * @param activeLow true if a relay is ON when its pin is LOW
      */
-    RelayController(const int* pins, int count);
+#ifdef ARDUINO
+    RelayController(const int* pins, int count, bool activeLow = false);
+#endif
+    
+    /**
+     * @brief Construct a Relay Controller on a custom output backend
+     * 
+     * @param output Output backend (e.g. MockRelayOutput), not owned
+     * @param count Number of relays
+     */
+    RelayController(RelayOutput& output, int count);
     
     /**
      * @brief Destroy the Relay Controller object
@@ -27,8 +43,10 @@ public:
     
     /**
      * @brief Initialize all relays
+     * 
+     * @param initialMask Relay states to start with (default: all OFF)
      */
-    void begin();
+    void begin(VanSight::RelayMask initialMask = 0);
     
     /**
      * @brief Turn on a specific relay
@@ -72,16 +90,55 @@ public:
      */
     void allOff();
     
+    /**
+     * @brief Set every relay at once
+     * 
+     * @param mask New relay states (bit 0 = relay 1)
+     */
+    void apply(VanSight::RelayMask mask);
+    
+    /**
+     * @brief Set several relays in one register write
+     * 
+     * Relays outside mask keep their state.
+     * 
+     * @param mask Relays to set (bit 0 = relay 1)
+     * @param values Target states of the relays in mask
+     * @return VanSight::RelayMask Relay states before the write
+     */
+    VanSight::RelayMask set(VanSight::RelayMask mask, VanSight::RelayMask values);
+    
+    /**
+     * @brief Get all relay states
+     * 
+     * @return VanSight::RelayMask Relay states (bit 0 = relay 1)
+     */
+    VanSight::RelayMask getMask() const { return _state; }
+    
     /**
      * @brief Get the total number of relays
      * 
-     * @return uint Number of relays
+     * @return unsigned int Number of relays
      */
-    uint getCount() const { return _count; }
+    unsigned int getCount() const { return _count; }
 
 private:
-    SimpleRelay** _relays;
+    RelayOutput* _output;
+    bool _ownsOutput;
     int _count;
+    VanSight::RelayMask _validMask;
+    volatile VanSight::RelayMask _state;
+    SpinLock _lock;
+    
+    /**
+     * @brief Clear and set bits of the state and write it out
+     * 
+     * @param clear Relays to turn off
+     * @param set Relays to turn on
+     * @param flip Relays to toggle
+     * @return VanSight::RelayMask Relay states before the write
+     */
+    VanSight::RelayMask update(VanSight::RelayMask clear, VanSight::RelayMask set, VanSight::RelayMask flip);
     
     /**
      * @brief Validate relay number
@@ -0,0 +1,64 @@
+#include "RelayJournal.h"
+#include <Preferences.h>
+
+using namespace VanSight;
+
+RelayJournal::RelayJournal(uint32_t debounceMs, uint32_t minIntervalMs)
+    : _debounceMs(debounceMs),
+      _minIntervalMs(minIntervalMs),
+      _pending(0),
+      _lastChange(0),
+      _committed(0),
+      _lastCommit(0),
+      _commitCount(0) {
+}
+
+RelayMask RelayJournal::restore() {
+    Preferences prefs;
+    RelayMask mask = 0;
+    if (prefs.begin("relays", true)) {
+        mask = prefs.getUShort("mask", 0);
+        prefs.end();
+    }
+    
+    _committed = mask;
+    _pending = mask;
+    return mask;
+}
+
+void RelayJournal::record(RelayMask mask) {
+    _pending = mask;
+    _lastChange = millis();
+}
+
+void RelayJournal::update() {
+    RelayMask pending = _pending;
+    if (pending == _committed) {
+        return;
+    }
+    
+    uint32_t now = millis();
+    if (now - _lastChange < _debounceMs) {
+        return;
+    }
+    if (_commitCount > 0 && now - _lastCommit < _minIntervalMs) {
+        return;
+    }
+    
+    commit(pending);
+}
+
+void RelayJournal::commit(RelayMask mask) {
+    Preferences prefs;
+    if (!prefs.begin("relays", false)) {
+        return;
+    }
+    
+    prefs.putUShort("mask", mask);
+    prefs.end();
+    
+    _committed = mask;
+    _lastCommit = millis();
+    _commitCount++;
+    Serial.printf("[Journal] Relay mask 0x%04X saved\n", mask);
+}
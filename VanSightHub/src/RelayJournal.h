@@ -0,0 +1,59 @@
+#ifndef RELAY_JOURNAL_H
+#define RELAY_JOURNAL_H
+
+#include <Arduino.h>
+#include <VanSightLib.h>
+
+/**
+ * @brief Persists the relay mask to NVS with bounded flash wear
+ *
+ * Changes are only noted in RAM. update() commits the latest mask once it
+ * has been stable for the debounce time, and never more often than the
+ * minimum interval, so a burst of toggles costs one NVS write.
+ */
+class RelayJournal {
+public:
+    /**
+     * @brief Construct a new Relay Journal object
+     *
+     * @param debounceMs Time the mask must be stable before it is written
+     * @param minIntervalMs Minimum time between two writes
+     */
+    RelayJournal(uint32_t debounceMs, uint32_t minIntervalMs);
+    
+    /**
+     * @brief Read the last committed mask from NVS
+     *
+     * @return VanSight::RelayMask Stored mask, 0 if nothing was stored
+     */
+    VanSight::RelayMask restore();
+    
+    /**
+     * @brief Note a new relay mask (cheap, safe from any task)
+     */
+    void record(VanSight::RelayMask mask);
+    
+    /**
+     * @brief Commit the pending mask when due (call from loop)
+     */
+    void update();
+    
+    /**
+     * @brief Get the number of NVS writes since boot
+     */
+    uint32_t getCommitCount() const { return _commitCount; }
+    
+private:
+    uint32_t _debounceMs;
+    uint32_t _minIntervalMs;
+    
+    volatile VanSight::RelayMask _pending;
+    volatile uint32_t _lastChange;
+    VanSight::RelayMask _committed;
+    uint32_t _lastCommit;
+    uint32_t _commitCount;
+    
+    void commit(VanSight::RelayMask mask);
+};
+
+#endif // RELAY_JOURNAL_H
@@ -0,0 +1,44 @@
+#include "RelayOutput.h"
+#include <Arduino.h>
+#include <soc/gpio_struct.h>
+
+GpioRelayOutput::GpioRelayOutput(const int* pins, int count, bool activeLow)
+    : _pins(pins),
+      _count(count > 32 ? 32 : count),
+      _activeLow(activeLow) {
+    for (int i = 0; i < _count; i++) {
+        _bank0Bits[i] = pins[i] < 32 ? (1u << pins[i]) : 0;
+        _bank1Bits[i] = pins[i] >= 32 ? (1u << (pins[i] - 32)) : 0;
+    }
+}
+
+void GpioRelayOutput::begin(uint32_t initialMask) {
+    // Latch the levels before enabling the drivers, so nothing clicks at boot
+    write(initialMask);
+    for (int i = 0; i < _count; i++) {
+        pinMode(_pins[i], OUTPUT);
+    }
+    write(initialMask);
+}
+
+void GpioRelayOutput::write(uint32_t mask) {
+    uint32_t high0 = 0, low0 = 0;
+    uint32_t high1 = 0, low1 = 0;
+    
+    for (int i = 0; i < _count; i++) {
+        bool high = ((mask >> i) & 1) != _activeLow;
+        if (high) {
+            high0 |= _bank0Bits[i];
+            high1 |= _bank1Bits[i];
+        } else {
+            low0 |= _bank0Bits[i];
+            low1 |= _bank1Bits[i];
+        }
+    }
+    
+    // One store per bank and direction
+    if (high0) GPIO.out_w1ts = high0;
+    if (low0) GPIO.out_w1tc = low0;
+    if (high1) GPIO.out1_w1ts.val = high1;
+    if (low1) GPIO.out1_w1tc.val = low1;
+}
@@ -0,0 +1,72 @@
+#ifndef RELAY_OUTPUT_H
+#define RELAY_OUTPUT_H
+
+#include <stdint.h>
+
+/**
+ * @brief Output backend that drives the relay coils
+ *
+ * RelayController keeps the logical relay mask and hands every change to a
+ * backend as one complete mask, so a backend can switch all relays at once.
+ */
+class RelayOutput {
+public:
+    virtual ~RelayOutput() {}
+    
+    /**
+     * @brief Prepare the outputs and drive the initial relay states
+     */
+    virtual void begin(uint32_t initialMask) = 0;
+    
+    /**
+     * @brief Drive every relay to the state in mask (bit 0 = relay 1)
+     */
+    virtual void write(uint32_t mask) = 0;
+};
+
+/**
+ * @brief Backend writing the ESP32 GPIO set/clear registers directly
+ *
+ * Set and clear masks are precomputed per GPIO bank (0-31, 32-39), so
+ * applying any relay mask costs at most four register stores and all
+ * relays of a bank switch in the same cycle.
+ */
+class GpioRelayOutput : public RelayOutput {
+public:
+    /**
+     * @brief Construct a new Gpio Relay Output object
+     *
+     * @param pins GPIO pin per relay
+     * @param count Number of relays (max 32)
+     * @param activeLow true if a relay is ON when its pin is LOW
+     */
+    GpioRelayOutput(const int* pins, int count, bool activeLow);
+    
+    void begin(uint32_t initialMask) override;
+    void write(uint32_t mask) override;
+    
+private:
+    const int* _pins;
+    int _count;
+    bool _activeLow;
+    
+    uint32_t _bank0Bits[32];    // GPIO 0-31 bit per relay (0 if in bank 1)
+    uint32_t _bank1Bits[32];    // GPIO 32-39 bit per relay (0 if in bank 0)
+};
+
+/**
+ * @brief Backend that only records what was written (host tests)
+ */
+class MockRelayOutput : public RelayOutput {
+public:
+    MockRelayOutput() : lastMask(0), writeCount(0), started(false) {}
+    
+    void begin(uint32_t initialMask) override { started = true; lastMask = initialMask; }
+    void write(uint32_t mask) override { lastMask = mask; writeCount++; }
+    
+    uint32_t lastMask;
+    uint32_t writeCount;
+    bool started;
+};
+
+#endif // RELAY_OUTPUT_H
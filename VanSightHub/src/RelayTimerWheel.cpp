@@ -0,0 +1,325 @@
+#include "RelayTimerWheel.h"
+#include <Preferences.h>
+
+// Layout of one persisted timer in NVS
+struct PersistedTimer {
+    uint32_t expiry;
+    uint8_t relay;
+    uint8_t action;
+    uint8_t reserved[2];
+};
+
+RelayTimerWheel::RelayTimerWheel()
+    : _free(0),
+      _activeCount(0),
+      _current(0),
+      _dirty(false),
+      _expireHandler(nullptr),
+      _mutex(nullptr) {
+    for (uint8_t l = 0; l < LEVELS; l++) {
+        for (uint8_t s = 0; s < SLOTS; s++) {
+            _slots[l][s] = NONE;
+        }
+    }
+    
+    // Free list is chained through next
+    for (int i = 0; i < POOL_SIZE; i++) {
+        _nodes[i].active = false;
+        _nodes[i].generation = 0;
+        _nodes[i].prev = NONE;
+        _nodes[i].next = (i + 1 < POOL_SIZE) ? i + 1 : NONE;
+    }
+}
+
+void RelayTimerWheel::begin(uint32_t now) {
+    if (!_mutex) {
+        _mutex = xSemaphoreCreateMutex();
+    }
+    _current = now;
+    
+    Preferences prefs;
+    if (!prefs.begin("timers", true)) {
+        return;
+    }
+    
+    PersistedTimer stored[POOL_SIZE];
+    size_t len = prefs.getBytes("pool", stored, sizeof(stored));
+    prefs.end();
+    
+    int count = len / sizeof(PersistedTimer);
+    for (int i = 0; i < count; i++) {
+        int8_t index = allocate();
+        if (index == NONE) break;
+        
+        Node& node = _nodes[index];
+        // Hub clock excludes powered-off time: the remaining delay resumes
+        node.expiry = max(stored[i].expiry, _current + 1);
+        node.relay = stored[i].relay;
+        node.action = stored[i].action;
+        link(index);
+    }
+    
+    if (count > 0) {
+        Serial.printf("[Timer] %d timers restored\n", count);
+    }
+}
+
+void RelayTimerWheel::onExpire(std::function<void(uint8_t, TimerAction)> handler) {
+    _expireHandler = handler;
+}
+
+void RelayTimerWheel::lock() const {
+    if (_mutex) {
+        xSemaphoreTake(_mutex, portMAX_DELAY);
+    }
+}
+
+void RelayTimerWheel::unlock() const {
+    if (_mutex) {
+        xSemaphoreGive(_mutex);
+    }
+}
+
+// ============================================================================
+// POOL AND SLOT LISTS
+// ============================================================================
+
+int8_t RelayTimerWheel::allocate() {
+    if (_free == NONE) {
+        return NONE;
+    }
+    
+    int8_t index = _free;
+    _free = _nodes[index].next;
+    
+    Node& node = _nodes[index];
+    node.active = true;
+    node.generation++;
+    if (node.generation == 0) {
+        node.generation = 1;
+    }
+    _activeCount++;
+    return index;
+}
+
+void RelayTimerWheel::release(int8_t index) {
+    _nodes[index].active = false;
+    _nodes[index].prev = NONE;
+    _nodes[index].next = _free;
+    _free = index;
+    _activeCount--;
+}
+
+void RelayTimerWheel::link(int8_t index) {
+    Node& node = _nodes[index];
+    uint32_t delta = node.expiry > _current ? node.expiry - _current : 0;
+    uint32_t target = _current + delta;
+    
+    if (delta < SLOTS) {
+        node.level = 0;
+        node.slot = target & (SLOTS - 1);
+    } else if (delta < (1u << (2 * SLOT_BITS))) {
+        node.level = 1;
+        node.slot = (target >> SLOT_BITS) & (SLOTS - 1);
+    } else {
+        // Beyond the wheel: park in the last level-2 slot, re-cascaded later
+        if (delta >= (1u << (3 * SLOT_BITS))) {
+            target = _current + (1u << (3 * SLOT_BITS)) - 1;
+        }
+        node.level = 2;
+        node.slot = (target >> (2 * SLOT_BITS)) & (SLOTS - 1);
+    }
+    
+    int8_t& head = _slots[node.level][node.slot];
+    node.prev = NONE;
+    node.next = head;
+    if (head != NONE) {
+        _nodes[head].prev = index;
+    }
+    head = index;
+}
+
+void RelayTimerWheel::unlink(int8_t index) {
+    Node& node = _nodes[index];
+    if (node.prev != NONE) {
+        _nodes[node.prev].next = node.next;
+    } else {
+        _slots[node.level][node.slot] = node.next;
+    }
+    if (node.next != NONE) {
+        _nodes[node.next].prev = node.prev;
+    }
+    node.prev = NONE;
+    node.next = NONE;
+}
+
+void RelayTimerWheel::cascade(uint8_t level, uint8_t slot) {
+    int8_t index = _slots[level][slot];
+    _slots[level][slot] = NONE;
+    
+    while (index != NONE) {
+        int8_t next = _nodes[index].next;
+        link(index);
+        index = next;
+    }
+}
+
+uint32_t RelayTimerWheel::makeId(int8_t index) const {
+    return ((uint32_t)_nodes[index].generation << 8) | (uint8_t)index;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+uint32_t RelayTimerWheel::add(uint32_t now, uint32_t delaySeconds, uint8_t relayNum, TimerAction action) {
+    lock();
+    int8_t index = allocate();
+    if (index == NONE) {
+        unlock();
+        return 0;
+    }
+    
+    Node& node = _nodes[index];
+    node.expiry = max(now + max(delaySeconds, (uint32_t)1), _current + 1);
+    node.relay = relayNum;
+    node.action = action;
+    link(index);
+    
+    uint32_t id = makeId(index);
+    _dirty = true;
+    unlock();
+    return id;
+}
+
+bool RelayTimerWheel::cancel(uint32_t id) {
+    int8_t index = id & 0xFF;
+    if (index < 0 || index >= POOL_SIZE) return false;
+    
+    lock();
+    Node& node = _nodes[index];
+    if (!node.active || node.generation != (id >> 8)) {
+        unlock();
+        return false;
+    }
+    
+    unlink(index);
+    release(index);
+    _dirty = true;
+    unlock();
+    return true;
+}
+
+int RelayTimerWheel::cancelRelay(uint8_t relayNum, uint32_t keepId) {
+    int cancelled = 0;
+    
+    lock();
+    for (int8_t i = 0; i < POOL_SIZE; i++) {
+        if (_nodes[i].active && _nodes[i].relay == relayNum && makeId(i) != keepId) {
+            unlink(i);
+            release(i);
+            cancelled++;
+        }
+    }
+    if (cancelled > 0) {
+        _dirty = true;
+    }
+    unlock();
+    return cancelled;
+}
+
+void RelayTimerWheel::tick(uint32_t now) {
+    uint8_t relays[POOL_SIZE];
+    uint8_t actions[POOL_SIZE];
+    int expired = 0;
+    
+    lock();
+    while (_current < now) {
+        _current++;
+        
+        uint8_t index0 = _current & (SLOTS - 1);
+        if (index0 == 0) {
+            uint8_t index1 = (_current >> SLOT_BITS) & (SLOTS - 1);
+            if (index1 == 0) {
+                cascade(2, (_current >> (2 * SLOT_BITS)) & (SLOTS - 1));
+            }
+            cascade(1, index1);
+        }
+        
+        int8_t index = _slots[0][index0];
+        _slots[0][index0] = NONE;
+        while (index != NONE) {
+            int8_t next = _nodes[index].next;
+            relays[expired] = _nodes[index].relay;
+            actions[expired] = _nodes[index].action;
+            expired++;
+            release(index);
+            index = next;
+        }
+    }
+    
+    if (expired > 0) {
+        _dirty = true;
+    }
+    if (_dirty) {
+        save();
+        _dirty = false;
+    }
+    unlock();
+    
+    // Actions run outside the lock so handlers may schedule new timers
+    for (int i = 0; i < expired; i++) {
+        Serial.printf("[Timer] Relay %d expired (action %d)\n", relays[i], actions[i]);
+        if (_expireHandler) {
+            _expireHandler(relays[i], (TimerAction)actions[i]);
+        }
+    }
+}
+
+int RelayTimerWheel::list(RelayTimerInfo out[], int max) const {
+    int count = 0;
+    
+    lock();
+    for (int8_t i = 0; i < POOL_SIZE && count < max; i++) {
+        if (_nodes[i].active) {
+            out[count].id = makeId(i);
+            out[count].expiry = _nodes[i].expiry;
+            out[count].relay = _nodes[i].relay;
+            out[count].action = (TimerAction)_nodes[i].action;
+            count++;
+        }
+    }
+    unlock();
+    return count;
+}
+
+// ============================================================================
+// PERSISTENCE
+// ============================================================================
+
+void RelayTimerWheel::save() {
+    PersistedTimer stored[POOL_SIZE];
+    int count = 0;
+    
+    for (int i = 0; i < POOL_SIZE; i++) {
+        if (_nodes[i].active) {
+            stored[count].expiry = _nodes[i].expiry;
+            stored[count].relay = _nodes[i].relay;
+            stored[count].action = _nodes[i].action;
+            stored[count].reserved[0] = 0;
+            stored[count].reserved[1] = 0;
+            count++;
+        }
+    }
+    
+    Preferences prefs;
+    if (!prefs.begin("timers", false)) {
+        return;
+    }
+    if (count == 0) {
+        prefs.remove("pool");
+    } else {
+        prefs.putBytes("pool", stored, count * sizeof(PersistedTimer));
+    }
+    prefs.end();
+}
@@ -0,0 +1,141 @@
+#ifndef RELAY_TIMER_WHEEL_H
+#define RELAY_TIMER_WHEEL_H
+
+#include <Arduino.h>
+#include <functional>
+
+/**
+ * @brief What a relay timer does when it expires
+ */
+enum TimerAction {
+    TIMER_RELAY_OFF = 0,
+    TIMER_RELAY_ON,
+    TIMER_RELAY_TOGGLE
+};
+
+/**
+ * @brief Active timer as reported to clients
+ */
+struct RelayTimerInfo {
+    uint32_t id;
+    uint32_t expiry;        // Hub clock seconds
+    uint8_t relay;
+    TimerAction action;
+};
+
+/**
+ * @brief Hierarchical timer wheel for scheduled relay actions
+ *
+ * Three levels of 64 slots with 1 s, 64 s and 4096 s resolution cover
+ * about three days; longer timers are re-cascaded until they fit. Timers
+ * live in a fixed pool and are linked into their slot by index, so insert
+ * and cancel are O(1) and nothing is allocated.
+ *
+ * Active timers are saved to NVS (absolute hub clock time) after every
+ * change and restored by begin(). The hub clock only counts powered-on
+ * seconds, so a restored timer resumes its remaining delay after reboot;
+ * time spent powered off does not count towards it.
+ *
+ * tick() runs the expiry callbacks from the caller's context (the hub
+ * loop), never from a radio callback.
+ */
+class RelayTimerWheel {
+public:
+    static const uint8_t POOL_SIZE = 32;
+    
+    RelayTimerWheel();
+    
+    /**
+     * @brief Restore persisted timers
+     *
+     * @param now Current hub clock (seconds)
+     */
+    void begin(uint32_t now);
+    
+    /**
+     * @brief Register the expiry handler
+     */
+    void onExpire(std::function<void(uint8_t relayNum, TimerAction action)> handler);
+    
+    /**
+     * @brief Schedule a relay action
+     *
+     * @param now Current hub clock (seconds)
+     * @param delaySeconds Seconds until the action (min 1)
+     * @return uint32_t Timer id, 0 if the pool is full
+     */
+    uint32_t add(uint32_t now, uint32_t delaySeconds, uint8_t relayNum, TimerAction action);
+    
+    /**
+     * @brief Cancel a timer
+     *
+     * @return true if the timer was active
+     */
+    bool cancel(uint32_t id);
+    
+    /**
+     * @brief Cancel every timer of a relay
+     *
+     * @param keepId Timer of this relay to leave running (0 = none)
+     * @return int Number of timers cancelled
+     */
+    int cancelRelay(uint8_t relayNum, uint32_t keepId = 0);
+    
+    /**
+     * @brief Advance the wheel to now and run expired actions
+     */
+    void tick(uint32_t now);
+    
+    /**
+     * @brief List active timers
+     *
+     * @return int Number of entries written
+     */
+    int list(RelayTimerInfo out[], int max) const;
+    
+    /**
+     * @brief Get number of active timers
+     */
+    int getActiveCount() const { return _activeCount; }
+    
+private:
+    static const uint8_t LEVELS = 3;
+    static const uint8_t SLOT_BITS = 6;
+    static const uint8_t SLOTS = 1 << SLOT_BITS;
+    static const int8_t NONE = -1;
+    
+    struct Node {
+        uint32_t expiry;
+        uint16_t generation;
+        uint8_t relay;
+        uint8_t action;
+        int8_t prev;
+        int8_t next;
+        uint8_t level;
+        uint8_t slot;
+        bool active;
+    };
+    
+    Node _nodes[POOL_SIZE];
+    int8_t _slots[LEVELS][SLOTS];
+    int8_t _free;
+    int _activeCount;
+    uint32_t _current;
+    bool _dirty;
+    
+    std::function<void(uint8_t, TimerAction)> _expireHandler;
+    SemaphoreHandle_t _mutex;
+    
+    void link(int8_t index);
+    void unlink(int8_t index);
+    void release(int8_t index);
+    int8_t allocate();
+    void cascade(uint8_t level, uint8_t slot);
+    uint32_t makeId(int8_t index) const;
+    void save();
+    
+    void lock() const;
+    void unlock() const;
+};
+
+#endif // RELAY_TIMER_WHEEL_H
@@ -0,0 +1,99 @@
+#include "SceneStore.h"
+#include <Preferences.h>
+
+using namespace VanSight;
+
+SceneStore::SceneStore()
+    : _count(0) {
+}
+
+void SceneStore::begin() {
+    Preferences prefs;
+    if (!prefs.begin("scenes", true)) {
+        return;
+    }
+    
+    size_t len = prefs.getBytes("table", _scenes, sizeof(_scenes));
+    prefs.end();
+    
+    if (len % sizeof(Scene) != 0) {
+        Serial.println("[Scene] Stored table is invalid, ignoring");
+        _count = 0;
+        return;
+    }
+    
+    _count = len / sizeof(Scene);
+    for (uint8_t i = 0; i < _count; i++) {
+        _scenes[i].name[sizeof(_scenes[i].name) - 1] = '\0';
+    }
+    Serial.printf("[Scene] %d scenes loaded\n", _count);
+}
+
+int SceneStore::indexOf(const char* name) const {
+    for (uint8_t i = 0; i < _count; i++) {
+        if (strcmp(_scenes[i].name, name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool SceneStore::persist() {
+    Preferences prefs;
+    if (!prefs.begin("scenes", false)) {
+        return false;
+    }
+    
+    bool ok;
+    if (_count == 0) {
+        prefs.remove("table");
+        ok = true;
+    } else {
+        size_t len = _count * sizeof(Scene);
+        ok = prefs.putBytes("table", _scenes, len) == len;
+    }
+    
+    prefs.end();
+    return ok;
+}
+
+bool SceneStore::save(const char* name, RelayMask target, RelayMask care) {
+    if (!name || name[0] == '\0' || strlen(name) >= sizeof(_scenes[0].name)) {
+        return false;
+    }
+    
+    int index = indexOf(name);
+    if (index < 0) {
+        if (_count >= MAX_SCENES) return false;
+        index = _count++;
+        strcpy(_scenes[index].name, name);
+    }
+    
+    _scenes[index].target = target & care;
+    _scenes[index].care = care;
+    return persist();
+}
+
+bool SceneStore::remove(const char* name) {
+    if (!name) return false;
+    
+    int index = indexOf(name);
+    if (index < 0) return false;
+    
+    for (uint8_t i = index; i + 1 < _count; i++) {
+        _scenes[i] = _scenes[i + 1];
+    }
+    _count--;
+    persist();
+    return true;
+}
+
+bool SceneStore::find(const char* name, Scene& scene) const {
+    if (!name) return false;
+    
+    int index = indexOf(name);
+    if (index < 0) return false;
+    
+    scene = _scenes[index];
+    return true;
+}
@@ -0,0 +1,72 @@
+#ifndef SCENE_STORE_H
+#define SCENE_STORE_H
+
+#include <Arduino.h>
+#include <VanSightLib.h>
+
+/**
+ * @brief Named relay scene
+ *
+ * Applying a scene sets every relay in `care` to its bit in `target` and
+ * leaves the other relays untouched.
+ */
+struct Scene {
+    char name[16];
+    VanSight::RelayMask target;
+    VanSight::RelayMask care;
+    
+    /**
+     * @brief Compute the relay mask after applying the scene
+     */
+    VanSight::RelayMask applyTo(VanSight::RelayMask current) const {
+        return (current & ~care) | (target & care);
+    }
+};
+
+/**
+ * @brief Scenes stored in NVS
+ */
+class SceneStore {
+public:
+    static const uint8_t MAX_SCENES = 8;
+    
+    SceneStore();
+    
+    /**
+     * @brief Load scenes from NVS
+     */
+    void begin();
+    
+    /**
+     * @brief Create or replace a scene and save it
+     *
+     * @return true if saved, false if the name is invalid or the store is full
+     */
+    bool save(const char* name, VanSight::RelayMask target, VanSight::RelayMask care);
+    
+    /**
+     * @brief Delete a scene
+     *
+     * @return true if the scene existed
+     */
+    bool remove(const char* name);
+    
+    /**
+     * @brief Find a scene by name
+     *
+     * @return true if found (copied into scene)
+     */
+    bool find(const char* name, Scene& scene) const;
+    
+    uint8_t getCount() const { return _count; }
+    const Scene& at(uint8_t index) const { return _scenes[index]; }
+    
+private:
+    Scene _scenes[MAX_SCENES];
+    uint8_t _count;
+    
+    int indexOf(const char* name) const;
+    bool persist();
+};
+
+#endif // SCENE_STORE_H
@@ -1,7 +1,20 @@
 #include "SensorController.h"
+#include <driver/adc.h>
+#include <Preferences.h>
+
+// NVS namespace for calibration tables (one key per sensor)
+#define CALIBRATION_NAMESPACE "calibration"
+
+// Bytes drained from the DMA buffer per read
+#define ADC_READ_LEN 256
 
 SensorController::SensorController(int count) 
-    : _count(count) {
+    : _count(count),
+      _continuous(false),
+      _oversampling(1),
+      _adcTask(nullptr),
+      _freshMask(0),
+      _readingsCallback(nullptr) {
     // Allocate array of LevelSensor pointers
     _sensors = new LevelSensor*[_count];
     
@@ -9,9 +22,24 @@ SensorController::SensorController(int count)
     for (int i = 0; i < _count; i++) {
         _sensors[i] = nullptr;
     }
+    
+    _latestRaw = new int[_count];
+    for (int i = 0; i < _count; i++) {
+        _latestRaw[i] = -1;
+    }
+    for (int c = 0; c < 8; c++) {
+        _channelToSensor[c] = -1;
+    }
 }
 
 SensorController::~SensorController() {
+    if (_adcTask) {
+        vTaskDelete(_adcTask);
+        adc_digi_stop();
+        adc_digi_deinitialize();
+    }
+    delete[] _latestRaw;
+    
     // Clean up all sensor objects
     for (int i = 0; i < _count; i++) {
         if (_sensors[i] != nullptr) {
@@ -38,6 +66,131 @@ void SensorController::begin() {
     }
 }
 
+bool SensorController::beginContinuous(uint32_t sampleRateHz, uint16_t oversampling) {
+    if (_continuous) return true;
+    
+    // Build the conversion pattern, one entry per sensor channel
+    adc_digi_pattern_config_t pattern[8] = {};
+    uint32_t channelMask = 0;
+    int patternCount = 0;
+    
+    for (int i = 0; i < _count; i++) {
+        if (_sensors[i] == nullptr) continue;
+        
+        int channel = _sensors[i]->getAdcChannel();
+        if (channel < 0) {
+            Serial.printf("[Sensor] Sensor %d is not on ADC1, using analogRead\n", i + 1);
+            return false;
+        }
+        
+        pattern[patternCount].atten = ADC_ATTEN_DB_11;
+        pattern[patternCount].channel = channel;
+        pattern[patternCount].unit = 0;  // ADC1
+        pattern[patternCount].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+        patternCount++;
+        
+        channelMask |= (1 << channel);
+        _channelToSensor[channel] = i;
+    }
+    
+    if (patternCount == 0) return false;
+    
+    adc_digi_init_config_t initConfig = {};
+    initConfig.max_store_buf_size = ADC_READ_LEN * 4;
+    initConfig.conv_num_each_intr = ADC_READ_LEN;
+    initConfig.adc1_chan_mask = channelMask;
+    initConfig.adc2_chan_mask = 0;
+    
+    if (adc_digi_initialize(&initConfig) != ESP_OK) {
+        Serial.println("[Sensor] ADC DMA init failed, using analogRead");
+        return false;
+    }
+    
+    adc_digi_configuration_t config = {};
+    config.conv_limit_en = true;
+    config.conv_limit_num = 250;
+    config.pattern_num = patternCount;
+    config.adc_pattern = pattern;
+    config.sample_freq_hz = sampleRateHz;
+    config.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+    
+    if (adc_digi_controller_configure(&config) != ESP_OK || adc_digi_start() != ESP_OK) {
+        Serial.println("[Sensor] ADC DMA start failed, using analogRead");
+        adc_digi_deinitialize();
+        return false;
+    }
+    
+    _oversampling = oversampling > 0 ? oversampling : 1;
+    xTaskCreate(adcTask, "adc_sampler", 4096, this, 2, &_adcTask);
+    
+    // Wait for the first averaged reading of every sensor
+    unsigned long start = millis();
+    bool ready = false;
+    while (!ready && millis() - start < 500) {
+        ready = true;
+        for (int i = 0; i < _count; i++) {
+            if (_sensors[i] != nullptr && _latestRaw[i] < 0) {
+                ready = false;
+            }
+        }
+        delay(5);
+    }
+    
+    _continuous = true;
+    Serial.printf("[Sensor] Continuous sampling: %u Hz, %u x oversampling\n", sampleRateHz, _oversampling);
+    return true;
+}
+
+void SensorController::adcTask(void* arg) {
+    SensorController* self = (SensorController*)arg;
+    uint8_t buffer[ADC_READ_LEN];
+    uint32_t sums[8] = {0};
+    uint16_t counts[8] = {0};
+    
+    while (true) {
+        uint32_t length = 0;
+        esp_err_t ret = adc_digi_read_bytes(buffer, sizeof(buffer), &length, ADC_MAX_DELAY);
+        
+        // ESP_ERR_INVALID_STATE means the DMA buffer overflowed; the data is still valid
+        if (ret == ESP_OK || ret == ESP_ERR_INVALID_STATE) {
+            self->processSamples(buffer, length, sums, counts);
+        }
+    }
+}
+
+void SensorController::processSamples(const uint8_t* buffer, uint32_t length, uint32_t sums[], uint16_t counts[]) {
+    for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= length; i += SOC_ADC_DIGI_RESULT_BYTES) {
+        const adc_digi_output_data_t* sample = (const adc_digi_output_data_t*)&buffer[i];
+        uint8_t channel = sample->type1.channel;
+        if (channel >= 8) continue;
+        
+        int sensor = _channelToSensor[channel];
+        if (sensor < 0) continue;
+        
+        sums[sensor] += sample->type1.data;
+        if (++counts[sensor] >= _oversampling) {
+            // Publish one averaged (decimated) and filtered reading
+            _latestRaw[sensor] = _sensors[sensor]->filter(sums[sensor] / counts[sensor]);
+            sums[sensor] = 0;
+            counts[sensor] = 0;
+            
+            // Notify once every sensor has a fresh reading
+            _freshMask |= (1u << sensor);
+            if (_freshMask == (1u << _count) - 1) {
+                _freshMask = 0;
+                if (_readingsCallback) {
+                    _readingsCallback();
+                }
+            }
+        }
+    }
+}
+
+void SensorController::onReadings(std::function<void()> callback) {
+    _readingsCallback = callback;
+}
+
 bool SensorController::isValidSensorNum(int sensorNum) const {
     return (sensorNum >= 1 && sensorNum <= _count && _sensors[sensorNum - 1] != nullptr);
 }
@@ -45,23 +198,161 @@ bool SensorController::isValidSensorNum(int sensorNum) const {
 float SensorController::readResistance(int sensorNum) {
     if (!isValidSensorNum(sensorNum)) return -1.0;
     
-    return _sensors[sensorNum - 1]->readResistance();
+    int raw = readRaw(sensorNum);
+    if (raw < 0) return -1.0;
+    
+    return _sensors[sensorNum - 1]->rawToResistance(raw);
 }
 
 int SensorController::readLevel(int sensorNum) {
     if (!isValidSensorNum(sensorNum)) return -1;
     
-    return _sensors[sensorNum - 1]->readLevel();
+    int raw = readRaw(sensorNum);
+    if (raw < 0) return -1;
+    
+    return _sensors[sensorNum - 1]->rawToLevel(raw);
 }
 
 float SensorController::readVoltage(int sensorNum) {
     if (!isValidSensorNum(sensorNum)) return -1.0;
     
-    return _sensors[sensorNum - 1]->readVoltage();
+    int raw = readRaw(sensorNum);
+    if (raw < 0) return -1.0;
+    
+    return _sensors[sensorNum - 1]->rawToVoltage(raw);
 }
 
 int SensorController::readRaw(int sensorNum) {
     if (!isValidSensorNum(sensorNum)) return -1;
     
-    return _sensors[sensorNum - 1]->readRaw();
+    // Latest averaged value from the DMA sampler (-1 until the first one)
+    if (_continuous) {
+        return _latestRaw[sensorNum - 1];
+    }
+    
+    return _sensors[sensorNum - 1]->filter(_sensors[sensorNum - 1]->readRaw());
+}
+
+void SensorController::readAll(SensorSnapshot& snapshot) {
+    snapshot.timestamp = millis();
+    snapshot.count = min(_count, MAX_SNAPSHOT_SENSORS);
+    
+    for (int i = 0; i < snapshot.count; i++) {
+        SensorReading& reading = snapshot.sensors[i];
+        
+        // One sample per sensor; every field is derived from it
+        reading.raw = readRaw(i + 1);
+        if (reading.raw < 0) {
+            reading.voltage = -1.0;
+            reading.resistance = -1.0;
+            reading.level = -1;
+            continue;
+        }
+        
+        LevelSensor* sensor = _sensors[i];
+        reading.voltage = sensor->rawToVoltage(reading.raw);
+        reading.resistance = sensor->rawToResistance(reading.raw);
+        reading.level = sensor->rawToLevel(reading.raw);
+    }
+}
+
+int SensorController::updateStableLevel(int sensorNum, int level) {
+    if (!isValidSensorNum(sensorNum) || level < 0) return -1;
+    
+    _sensors[sensorNum - 1]->updateLevel(level);
+    return _sensors[sensorNum - 1]->getReportedLevel();
+}
+
+void SensorController::setFilter(int sensorNum, const FilterConfig& config) {
+    for (int i = 0; i < _count; i++) {
+        if (_sensors[i] != nullptr && (sensorNum == 0 || sensorNum == i + 1)) {
+            _sensors[i]->setFilter(config);
+        }
+    }
+}
+
+void SensorController::setChangeThresholds(int sensorNum, uint8_t deadband, uint8_t hysteresis) {
+    for (int i = 0; i < _count; i++) {
+        if (_sensors[i] != nullptr && (sensorNum == 0 || sensorNum == i + 1)) {
+            _sensors[i]->setChangeThresholds(deadband, hysteresis);
+        }
+    }
+}
+
+// ============================================================================
+// CALIBRATION
+// ============================================================================
+
+void SensorController::loadCalibration() {
+    Preferences prefs;
+    if (!prefs.begin(CALIBRATION_NAMESPACE, true)) {
+        return;
+    }
+    
+    for (int i = 0; i < _count; i++) {
+        if (_sensors[i] == nullptr) continue;
+        
+        char key[12];
+        snprintf(key, sizeof(key), "sensor%d", i + 1);
+        
+        CalibrationPoint points[CalibrationTable::MAX_POINTS];
+        size_t len = prefs.getBytes(key, points, sizeof(points));
+        if (len == 0 || len % sizeof(CalibrationPoint) != 0) continue;
+        
+        uint8_t count = len / sizeof(CalibrationPoint);
+        if (_sensors[i]->getCalibration().setPoints(points, count)) {
+            Serial.printf("[Sensor] Sensor %d: %d calibration points loaded\n", i + 1, count);
+        }
+    }
+    
+    prefs.end();
+}
+
+bool SensorController::saveCalibration(int sensorNum) {
+    Preferences prefs;
+    if (!prefs.begin(CALIBRATION_NAMESPACE, false)) {
+        return false;
+    }
+    
+    char key[12];
+    snprintf(key, sizeof(key), "sensor%d", sensorNum);
+    
+    const CalibrationTable& table = _sensors[sensorNum - 1]->getCalibration();
+    bool ok;
+    if (table.getCount() == 0) {
+        ok = prefs.remove(key) || !prefs.isKey(key);
+    } else {
+        size_t len = table.getCount() * sizeof(CalibrationPoint);
+        ok = prefs.putBytes(key, table.getPoints(), len) == len;
+    }
+    
+    prefs.end();
+    return ok;
+}
+
+bool SensorController::addCalibrationPoint(int sensorNum, uint16_t level, int& raw) {
+    if (!isValidSensorNum(sensorNum)) return false;
+    
+    raw = readRaw(sensorNum);
+    if (raw < 0) return false;
+    
+    // Edit a copy so readers never see a half-shifted table
+    CalibrationTable table = _sensors[sensorNum - 1]->getCalibration();
+    if (!table.addPoint(raw, level)) return false;
+    _sensors[sensorNum - 1]->getCalibration() = table;
+    
+    return saveCalibration(sensorNum);
+}
+
+bool SensorController::clearCalibration(int sensorNum) {
+    if (!isValidSensorNum(sensorNum)) return false;
+    
+    _sensors[sensorNum - 1]->getCalibration().clear();
+    return saveCalibration(sensorNum);
+}
+
+const CalibrationTable* SensorController::getCalibration(int sensorNum) const {
+    if (!isValidSensorNum(sensorNum)) return nullptr;
+    
+    return &_sensors[sensorNum - 1]->getCalibration();
 }
@@ -2,8 +2,30 @@
 #define SENSOR_CONTROLLER_H
 
 #include <Arduino.h>
+#include <functional>
 #include "LevelSensor.h"
 
+#define MAX_SNAPSHOT_SENSORS 8
+
+/**
+ * @brief All values of one sensor derived from a single sample
+ */
+struct SensorReading {
+    int raw;            // Filtered ADC value (0-4095), -1 if not available
+    float voltage;      // Volts
+    float resistance;   // Ohms
+    int level;          // Level percentage (0-100)
+};
+
+/**
+ * @brief Consistent readings of all sensors
+ */
+struct SensorSnapshot {
+    uint32_t timestamp;     // millis() when the snapshot was taken
+    int count;              // Valid entries in sensors[]
+    SensorReading sensors[MAX_SNAPSHOT_SENSORS];
+};
+
 /**
  * @brief SensorController class for managing multiple level sensors
  * 
@@ -41,6 +63,34 @@ public:
      */
     void begin();
     
+    /**
+     * @brief Start continuous (DMA) sampling of all sensors
+     * 
+     * A background task drains the ADC DMA buffer and averages every
+     * `oversampling` conversions of a channel into one reading. Readers
+     * get the latest averaged value instead of doing an analogRead.
+     * Falls back to analogRead if a sensor is not on ADC1 or the driver
+     * fails to start.
+     * 
+     * @param sampleRateHz Total conversions per second across all channels
+     * @param oversampling Conversions averaged into one reading
+     * @return true if continuous sampling is running
+     */
+    bool beginContinuous(uint32_t sampleRateHz, uint16_t oversampling);
+    
+    /**
+     * @brief Check if continuous sampling is running
+     */
+    bool isContinuous() const { return _continuous; }
+    
+    /**
+     * @brief Register callback for fresh readings
+     * 
+     * Called from the sampling task each time every sensor has published
+     * a new averaged reading. Keep it short (e.g. signal a task).
+     */
+    void onReadings(std::function<void()> callback);
+    
     /**
      * @brief Read resistance from a specific sensor
      * 
@@ -73,6 +123,72 @@ public:
      */
     int readRaw(int sensorNum);
     
+    /**
+     * @brief Sample every sensor once and fill all derived values
+     * 
+     * @param snapshot Snapshot to fill (sensors[i] is sensor i + 1)
+     */
+    void readAll(SensorSnapshot& snapshot);
+    
+    /**
+     * @brief Feed a level into the sensor's change detector
+     * 
+     * Small movements inside the deadband/hysteresis are absorbed, so the
+     * returned level only changes on meaningful transitions.
+     * 
+     * @param sensorNum Sensor number (1-based index)
+     * @param level Level percentage from a reading
+     * @return int Reported level percentage (0-100), -1 if invalid sensor
+     */
+    int updateStableLevel(int sensorNum, int level);
+    
+    /**
+     * @brief Configure the filter chain of a sensor
+     * 
+     * @param sensorNum Sensor number (1-based index), 0 for all sensors
+     */
+    void setFilter(int sensorNum, const FilterConfig& config);
+    
+    /**
+     * @brief Configure change detection of a sensor
+     * 
+     * @param sensorNum Sensor number (1-based index), 0 for all sensors
+     * @param deadband Minimum level change (%) that is reported
+     * @param hysteresis Extra change (%) needed to reverse direction
+     */
+    void setChangeThresholds(int sensorNum, uint8_t deadband, uint8_t hysteresis);
+    
+    /**
+     * @brief Load calibration tables from NVS
+     */
+    void loadCalibration();
+    
+    /**
+     * @brief Capture the current reading as a calibration point and save it
+     * 
+     * @param sensorNum Sensor number (1-based index)
+     * @param level Level of the point in permille (0-1000)
+     * @param raw Receives the captured raw ADC value
+     * @return true if the point was stored
+     */
+    bool addCalibrationPoint(int sensorNum, uint16_t level, int& raw);
+    
+    /**
+     * @brief Remove the calibration table of a sensor (back to min/max mapping)
+     * 
+     * @param sensorNum Sensor number (1-based index)
+     * @return true if successful
+     */
+    bool clearCalibration(int sensorNum);
+    
+    /**
+     * @brief Get the calibration table of a sensor
+     * 
+     * @param sensorNum Sensor number (1-based index)
+     * @return const CalibrationTable* Table, nullptr if invalid sensor
+     */
+    const CalibrationTable* getCalibration(int sensorNum) const;
+    
     /**
      * @brief Get the total number of sensors
      * 
@@ -84,6 +200,18 @@ private:
     LevelSensor** _sensors;
     int _count;
     
+    // Continuous sampling state
+    bool _continuous;
+    uint16_t _oversampling;
+    volatile int* _latestRaw;
+    int8_t _channelToSensor[8];
+    TaskHandle_t _adcTask;
+    uint32_t _freshMask;
+    std::function<void()> _readingsCallback;
+    
+    static void adcTask(void* arg);
+    void processSamples(const uint8_t* buffer, uint32_t length, uint32_t sums[], uint16_t counts[]);
+    
     /**
      * @brief Validate sensor number
      * 
@@ -91,6 +219,8 @@ private:
      * @return true if valid, false otherwise
      */
     bool isValidSensorNum(int sensorNum) const;
+    
+    bool saveCalibration(int sensorNum);
 };
 
 #endif // SENSOR_CONTROLLER_H
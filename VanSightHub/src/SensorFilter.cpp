@@ -0,0 +1,134 @@
+#include "SensorFilter.h"
+
+// ============================================================================
+// SENSOR FILTER
+// ============================================================================
+
+SensorFilter::SensorFilter() {
+    _config.medianWindow = 1;
+    _config.emaShift = 0;
+    _config.slewLimit = 0;
+    reset();
+}
+
+void SensorFilter::configure(const FilterConfig& config) {
+    _config = config;
+    if (_config.medianWindow > MAX_MEDIAN_WINDOW) {
+        _config.medianWindow = MAX_MEDIAN_WINDOW;
+    }
+    if (_config.emaShift > 15) {
+        _config.emaShift = 15;
+    }
+    reset();
+}
+
+void SensorFilter::reset() {
+    _windowIndex = 0;
+    _windowFill = 0;
+    _emaQ8 = 0;
+    _output = 0;
+    _primed = false;
+}
+
+int32_t SensorFilter::median(int32_t raw) {
+    _window[_windowIndex] = raw;
+    _windowIndex = (_windowIndex + 1) % _config.medianWindow;
+    if (_windowFill < _config.medianWindow) {
+        _windowFill++;
+    }
+    
+    // Insertion sort on a stack copy; the window is tiny
+    int32_t sorted[MAX_MEDIAN_WINDOW];
+    for (uint8_t i = 0; i < _windowFill; i++) {
+        int32_t value = _window[i];
+        int j = i;
+        while (j > 0 && sorted[j - 1] > value) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = value;
+    }
+    
+    return sorted[_windowFill / 2];
+}
+
+int32_t SensorFilter::process(int32_t raw) {
+    int32_t value = raw;
+    
+    if (_config.medianWindow > 1) {
+        value = median(value);
+    }
+    
+    if (!_primed) {
+        // First sample seeds every stage
+        _emaQ8 = value << 8;
+        _output = value;
+        _primed = true;
+        return _output;
+    }
+    
+    if (_config.emaShift > 0) {
+        _emaQ8 += ((value << 8) - _emaQ8) >> _config.emaShift;
+        value = (_emaQ8 + 128) >> 8;
+    }
+    
+    if (_config.slewLimit > 0) {
+        int32_t step = value - _output;
+        if (step > _config.slewLimit) {
+            value = _output + _config.slewLimit;
+        } else if (step < -(int32_t)_config.slewLimit) {
+            value = _output - _config.slewLimit;
+        }
+    }
+    
+    _output = value;
+    return _output;
+}
+
+// ============================================================================
+// CHANGE DETECTOR
+// ============================================================================
+
+ChangeDetector::ChangeDetector()
+    : _deadband(1),
+      _hysteresis(0) {
+    reset();
+}
+
+void ChangeDetector::configure(uint8_t deadband, uint8_t hysteresis) {
+    _deadband = deadband > 0 ? deadband : 1;
+    _hysteresis = hysteresis;
+    reset();
+}
+
+void ChangeDetector::reset() {
+    _reported = -1;
+    _direction = 0;
+}
+
+bool ChangeDetector::update(int32_t level) {
+    if (_reported < 0) {
+        _reported = level;
+        return true;
+    }
+    
+    int32_t delta = level - _reported;
+    if (delta == 0) {
+        return false;
+    }
+    
+    int8_t direction = delta > 0 ? 1 : -1;
+    int32_t threshold = _deadband;
+    if (_direction != 0 && direction != _direction) {
+        threshold += _hysteresis;
+    }
+    
+    int32_t magnitude = delta > 0 ? delta : -delta;
+    if (magnitude < threshold) {
+        return false;
+    }
+    
+    _reported = level;
+    _direction = direction;
+    return true;
+}
@@ -0,0 +1,98 @@
+#ifndef SENSOR_FILTER_H
+#define SENSOR_FILTER_H
+
+#include <stdint.h>
+
+/**
+ * @brief Filter chain settings for one sensor
+ *
+ * Stages run in order: median -> EMA -> slew limit. A stage is
+ * disabled by setting its parameter to 0 (median window 0 or 1).
+ */
+struct FilterConfig {
+    uint8_t medianWindow;   // Samples in the median window (max SensorFilter::MAX_MEDIAN_WINDOW)
+    uint8_t emaShift;       // EMA alpha = 1 / 2^emaShift
+    uint16_t slewLimit;     // Max raw step per sample
+};
+
+/**
+ * @brief Fixed-point, allocation-free filter chain for raw ADC codes
+ *
+ * Has no Arduino dependencies so it can be built and fed recorded
+ * traces on the host.
+ */
+class SensorFilter {
+public:
+    static const uint8_t MAX_MEDIAN_WINDOW = 9;
+    
+    SensorFilter();
+    
+    /**
+     * @brief Apply new settings and reset the state
+     */
+    void configure(const FilterConfig& config);
+    
+    /**
+     * @brief Forget all history (next sample passes through unchanged)
+     */
+    void reset();
+    
+    /**
+     * @brief Run one raw sample through the chain
+     *
+     * @param raw Raw ADC value
+     * @return int32_t Filtered value
+     */
+    int32_t process(int32_t raw);
+    
+    const FilterConfig& getConfig() const { return _config; }
+    
+private:
+    FilterConfig _config;
+    
+    int32_t _window[MAX_MEDIAN_WINDOW];
+    uint8_t _windowIndex;
+    uint8_t _windowFill;
+    
+    int32_t _emaQ8;     // EMA state in Q24.8
+    int32_t _output;
+    bool _primed;
+    
+    int32_t median(int32_t raw);
+};
+
+/**
+ * @brief Turns a noisy level into change events
+ *
+ * A new level is reported only if it moved at least `deadband` from the
+ * last reported level. Reversing direction needs an extra `hysteresis`,
+ * so a reading sitting on a boundary does not flap.
+ */
+class ChangeDetector {
+public:
+    ChangeDetector();
+    
+    void configure(uint8_t deadband, uint8_t hysteresis);
+    void reset();
+    
+    /**
+     * @brief Feed a level
+     *
+     * @param level Current level
+     * @return true if the reported level changed
+     */
+    bool update(int32_t level);
+    
+    /**
+     * @brief Get the last reported level (-1 before the first update)
+     */
+    int32_t getReported() const { return _reported; }
+    
+private:
+    uint8_t _deadband;
+    uint8_t _hysteresis;
+    int32_t _reported;
+    int8_t _direction;  // Direction of the last reported change (-1, 0, 1)
+};
+
+#endif // SENSOR_FILTER_H
@@ -0,0 +1,40 @@
+#ifndef SPIN_LOCK_H
+#define SPIN_LOCK_H
+
+#ifdef ARDUINO
+#include <freertos/FreeRTOS.h>
+#else
+#include <mutex>
+#endif
+
+/**
+ * @brief Short critical section that also builds on the host
+ *
+ * On the ESP32 this is a portMUX spinlock (safe across both cores, keep
+ * the section short and non-blocking); host builds use a std::mutex.
+ */
+class SpinLock {
+public:
+#ifdef ARDUINO
+    SpinLock() : _mux(portMUX_INITIALIZER_UNLOCKED) {}
+    
+    void lock() { portENTER_CRITICAL(&_mux); }
+    void unlock() { portEXIT_CRITICAL(&_mux); }
+    
+private:
+    portMUX_TYPE _mux;
+#else
+    SpinLock() {}
+    
+    void lock() { _mutex.lock(); }
+    void unlock() { _mutex.unlock(); }
+    
+private:
+    std::mutex _mutex;
+#endif
+    
+    SpinLock(const SpinLock&) = delete;
+    SpinLock& operator=(const SpinLock&) = delete;
+};
+
+#endif // SPIN_LOCK_H
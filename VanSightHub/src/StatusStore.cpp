@@ -0,0 +1,161 @@
+#include "StatusStore.h"
+#include <ArduinoJson.h>
+
+using namespace VanSight;
+
+StatusStore::StatusStore(int relayCount, int sensorCount)
+    : _relayCount(min(relayCount, MAX_RELAYS)),
+      _sensorCount(min(sensorCount, MAX_SENSORS)),
+      _relayMask(0),
+      _version(1),
+      _mutex(nullptr) {
+    for (int i = 0; i < MAX_SENSORS; i++) {
+        _levels[i] = -1;
+        _resistances[i] = -1.0;
+    }
+    for (int c = 0; c < CODEC_COUNT; c++) {
+        _frameLengths[c] = 0;
+        _frameVersions[c] = 0;
+    }
+}
+
+void StatusStore::begin() {
+    if (!_mutex) {
+        _mutex = xSemaphoreCreateMutex();
+    }
+}
+
+void StatusStore::lock() const {
+    if (_mutex) {
+        xSemaphoreTake(_mutex, portMAX_DELAY);
+    }
+}
+
+void StatusStore::unlock() const {
+    if (_mutex) {
+        xSemaphoreGive(_mutex);
+    }
+}
+
+// ============================================================================
+// SETTERS
+// ============================================================================
+
+bool StatusStore::setRelayMask(RelayMask mask) {
+    lock();
+    bool changed = (mask != _relayMask);
+    if (changed) {
+        _relayMask = mask;
+        _version++;
+    }
+    unlock();
+    return changed;
+}
+
+bool StatusStore::setSensor(int sensorNum, int level, float resistance) {
+    if (sensorNum < 1 || sensorNum > _sensorCount) return false;
+    
+    int i = sensorNum - 1;
+    lock();
+    bool levelChanged = (level != _levels[i]);
+    // Resistance is shown on the dashboard with 0.1Ω precision
+    bool resistanceChanged = fabsf(resistance - _resistances[i]) >= 0.05f;
+    if (levelChanged || resistanceChanged) {
+        _levels[i] = level;
+        _resistances[i] = resistance;
+        _version++;
+    }
+    unlock();
+    return levelChanged;
+}
+
+// ============================================================================
+// GETTERS
+// ============================================================================
+
+RelayMask StatusStore::getRelayMask() const {
+    return _relayMask;
+}
+
+int StatusStore::getSensorLevel(int sensorNum) const {
+    if (sensorNum < 1 || sensorNum > _sensorCount) return -1;
+    return _levels[sensorNum - 1];
+}
+
+float StatusStore::getSensorResistance(int sensorNum) const {
+    if (sensorNum < 1 || sensorNum > _sensorCount) return -1.0;
+    return _resistances[sensorNum - 1];
+}
+
+void StatusStore::getStatus(AllStatusData& data) const {
+    lock();
+    for (int i = 0; i < MAX_RELAYS; i++) {
+        data.relayStates[i] = (_relayMask >> i) & 1;
+    }
+    for (int i = 0; i < MAX_SENSORS; i++) {
+        data.sensorLevels[i] = _levels[i];
+    }
+    unlock();
+}
+
+size_t StatusStore::copyFrame(StatusCodec codec, char* buffer, size_t size) {
+    if (codec >= CODEC_COUNT) return 0;
+    
+    lock();
+    if (_frameVersions[codec] != _version) {
+        encode(codec);
+    }
+    
+    size_t len = _frameLengths[codec];
+    if (len == 0 || len > size) {
+        unlock();
+        return 0;
+    }
+    memcpy(buffer, _frames[codec], len);
+    unlock();
+    return len;
+}
+
+// ============================================================================
+// ENCODING
+// ============================================================================
+
+void StatusStore::encode(StatusCodec codec) {
+    JsonDocument doc;
+    doc["status"] = "ok";
+    JsonObject data = doc["data"].to<JsonObject>();
+    
+    JsonArray relays = data["relays"].to<JsonArray>();
+    for (int i = 0; i < _relayCount; i++) {
+        relays.add((_relayMask >> i) & 1);
+    }
+    
+    JsonArray sensors = data["sensors"].to<JsonArray>();
+    for (int i = 0; i < _sensorCount; i++) {
+        JsonObject sensor = sensors.add<JsonObject>();
+        sensor["id"] = i + 1;
+        if (codec == CODEC_WEB) {
+            sensor["resistance"] = round(_resistances[i] * 10) / 10.0;
+        }
+        sensor["level"] = _levels[i];
+    }
+    
+    if (codec == CODEC_WEB) {
+        doc["message"] = "Complete system status";
+    }
+    
+    size_t len = serializeJson(doc, _frames[codec], FRAME_SIZE - 1);
+    if (len == 0 || len >= FRAME_SIZE - 1) {
+        Serial.println("[Status] Frame too large");
+        _frameLengths[codec] = 0;
+        return;
+    }
+    
+    // BLE framing is newline-delimited
+    if (codec == CODEC_BLE) {
+        _frames[codec][len++] = '\n';
+    }
+    
+    _frameLengths[codec] = len;
+    _frameVersions[codec] = _version;
+}
@@ -0,0 +1,122 @@
+#ifndef STATUS_STORE_H
+#define STATUS_STORE_H
+
+#include <Arduino.h>
+#include <VanSightLib.h>
+
+/**
+ * @brief Wire encodings the status frame is cached in
+ */
+enum StatusCodec {
+    CODEC_BLE = 0,   // Compact relays + levels, newline-terminated (BLE / display)
+    CODEC_WEB,       // Relays + levels + resistance (dashboard / CommandHandler)
+    CODEC_COUNT
+};
+
+/**
+ * @brief Central store for the latest hub state
+ *
+ * Keeps the relay mask and the latest filtered sensor values together with
+ * one pre-serialized status frame per codec. Setters only mark the frames
+ * dirty when a value really changes; a frame is re-encoded lazily on the
+ * next request, so status requests from any transport are a memcpy.
+ *
+ * All methods are safe to call from the BLE, WebSocket and loop tasks.
+ */
+class StatusStore {
+public:
+    /**
+     * @brief Construct a new Status Store object
+     *
+     * @param relayCount Number of relays (max VanSight::MAX_RELAYS)
+     * @param sensorCount Number of sensors (max VanSight::MAX_SENSORS)
+     */
+    StatusStore(int relayCount, int sensorCount);
+    
+    /**
+     * @brief Create the lock (call once from setup)
+     */
+    void begin();
+    
+    /**
+     * @brief Replace the relay mask
+     *
+     * @return true if the mask changed
+     */
+    bool setRelayMask(VanSight::RelayMask mask);
+    
+    /**
+     * @brief Store the latest value of one sensor
+     *
+     * @param sensorNum Sensor number (1-based index)
+     * @param level Level percentage (0-100)
+     * @param resistance Resistance in ohms
+     * @return true if the level changed
+     */
+    bool setSensor(int sensorNum, int level, float resistance);
+    
+    /**
+     * @brief Get the relay mask (bit 0 = relay 1)
+     */
+    VanSight::RelayMask getRelayMask() const;
+    
+    /**
+     * @brief Get the latest level of a sensor
+     *
+     * @param sensorNum Sensor number (1-based index)
+     * @return int Level percentage, -1 if invalid or not yet sampled
+     */
+    int getSensorLevel(int sensorNum) const;
+    
+    /**
+     * @brief Get the latest resistance of a sensor
+     *
+     * @param sensorNum Sensor number (1-based index)
+     * @return float Resistance in ohms, -1 if invalid or not yet sampled
+     */
+    float getSensorResistance(int sensorNum) const;
+    
+    /**
+     * @brief Fill an AllStatusData structure from memory
+     */
+    void getStatus(VanSight::AllStatusData& data) const;
+    
+    /**
+     * @brief Copy the cached status frame for a codec
+     *
+     * Re-encodes the frame first if something changed since the last call.
+     *
+     * @return size_t Frame length, 0 if buffer is too small
+     */
+    size_t copyFrame(StatusCodec codec, char* buffer, size_t size);
+    
+    /**
+     * @brief Get the state version (incremented on every change)
+     */
+    uint32_t getVersion() const { return _version; }
+    
+    int getRelayCount() const { return _relayCount; }
+    int getSensorCount() const { return _sensorCount; }
+    
+private:
+    int _relayCount;
+    int _sensorCount;
+    
+    VanSight::RelayMask _relayMask;
+    int _levels[VanSight::MAX_SENSORS];
+    float _resistances[VanSight::MAX_SENSORS];
+    volatile uint32_t _version;
+    
+    static const size_t FRAME_SIZE = 512;
+    char _frames[CODEC_COUNT][FRAME_SIZE];
+    size_t _frameLengths[CODEC_COUNT];
+    uint32_t _frameVersions[CODEC_COUNT];
+    
+    SemaphoreHandle_t _mutex;
+    
+    void lock() const;
+    void unlock() const;
+    void encode(StatusCodec codec);
+};
+
+#endif // STATUS_STORE_H
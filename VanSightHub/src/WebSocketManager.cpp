@@ -0,0 +1,157 @@
+#include "WebSocketManager.h"
+#include <LittleFS.h>
+
+WebSocketManager::WebSocketManager()
+    : _server(80),
+      _ws(nullptr),
+      _initialized(false),
+      _commandHandler(nullptr),
+      _statusFrameHandler(nullptr) {
+}
+
+bool WebSocketManager::begin(const char* path) {
+    if (_initialized) {
+        return true;
+    }
+    
+    if (!LittleFS.begin(true)) {
+        Serial.println("[WebSocket] LittleFS mount failed");
+        return false;
+    }
+    
+    _ws = new AsyncWebSocket(path);
+    _ws->onEvent([this](AsyncWebSocket* server, AsyncWebSocketClient* client,
+                        AwsEventType type, void* arg, uint8_t* data, size_t len) {
+        handleEvent(client, type, arg, data, len);
+    });
+    
+    _server.addHandler(_ws);
+    _server.serveStatic("/", LittleFS, "/").setDefaultFile("index.html");
+    _server.onNotFound([](AsyncWebServerRequest* request) {
+        request->send(404, "text/plain", "Not found");
+    });
+    _server.begin();
+    
+    _initialized = true;
+    Serial.printf("[WebSocket] Dashboard ready on ws://<hub>%s\n", path);
+    return true;
+}
+
+void WebSocketManager::onCommand(std::function<void(uint32_t, const uint8_t*, size_t, JsonDocument&)> handler) {
+    _commandHandler = handler;
+}
+
+void WebSocketManager::onStatusFrameRequest(std::function<size_t(char*, size_t)> handler) {
+    _statusFrameHandler = handler;
+}
+
+// ============================================================================
+// BROADCASTS
+// ============================================================================
+
+void WebSocketManager::broadcastRelayState(uint8_t relayNum, bool state) {
+    JsonDocument doc;
+    doc["status"] = "ok";
+    JsonObject data = doc["data"].to<JsonObject>();
+    data["relay"] = relayNum;
+    data["state"] = state ? "on" : "off";
+    broadcast(doc);
+}
+
+void WebSocketManager::broadcastRelayDelta(uint16_t changed, uint16_t state) {
+    JsonDocument doc;
+    doc["status"] = "ok";
+    JsonObject data = doc["data"].to<JsonObject>();
+    data["changed"] = changed;
+    data["mask"] = state;
+    broadcast(doc);
+}
+
+void WebSocketManager::broadcastSensors(const int levels[], const float resistances[], int count) {
+    JsonDocument doc;
+    doc["status"] = "ok";
+    JsonArray sensors = doc["data"]["sensors"].to<JsonArray>();
+    for (int i = 0; i < count; i++) {
+        JsonObject sensor = sensors.add<JsonObject>();
+        sensor["id"] = i + 1;
+        sensor["resistance"] = round(resistances[i] * 10) / 10.0;
+        sensor["level"] = levels[i];
+    }
+    broadcast(doc);
+}
+
+void WebSocketManager::broadcast(const JsonDocument& doc) {
+    if (!_ws || _ws->count() == 0) {
+        return;
+    }
+    
+    // Encode once, fan out to every browser
+    char buffer[FRAME_BUFFER_SIZE];
+    size_t len = serializeJson(doc, buffer, sizeof(buffer));
+    if (len == 0 || len >= sizeof(buffer)) {
+        Serial.println("[WebSocket] Frame too large, dropped");
+        return;
+    }
+    
+    _ws->textAll(buffer, len);
+}
+
+void WebSocketManager::cleanupClients() {
+    if (_ws) {
+        _ws->cleanupClients();
+    }
+}
+
+size_t WebSocketManager::getClientCount() const {
+    return _ws ? _ws->count() : 0;
+}
+
+// ============================================================================
+// INTERNAL HANDLERS
+// ============================================================================
+
+void WebSocketManager::handleEvent(AsyncWebSocketClient* client, AwsEventType type, void* arg, uint8_t* data, size_t len) {
+    switch (type) {
+        case WS_EVT_CONNECT:
+            Serial.printf("[WebSocket] Client #%u connected (%u total)\n", client->id(), _ws->count());
+            if (_statusFrameHandler) {
+                char buffer[FRAME_BUFFER_SIZE];
+                size_t frameLen = _statusFrameHandler(buffer, sizeof(buffer));
+                if (frameLen > 0) {
+                    client->text(buffer, frameLen);
+                }
+            }
+            break;
+        
+        case WS_EVT_DISCONNECT:
+            Serial.printf("[WebSocket] Client #%u disconnected\n", client->id());
+            break;
+        
+        case WS_EVT_DATA: {
+            AwsFrameInfo* info = (AwsFrameInfo*)arg;
+            // Commands are small; only accept complete single-frame text messages
+            if (info->final && info->index == 0 && info->len == len && info->opcode == WS_TEXT) {
+                handleCommand(client, data, len);
+            }
+            break;
+        }
+        
+        default:
+            break;
+    }
+}
+
+void WebSocketManager::handleCommand(AsyncWebSocketClient* client, const uint8_t* data, size_t len) {
+    if (!_commandHandler) {
+        return;
+    }
+    
+    JsonDocument response;
+    _commandHandler(client->id(), data, len, response);
+    
+    char buffer[FRAME_BUFFER_SIZE];
+    size_t outLen = serializeJson(response, buffer, sizeof(buffer));
+    if (outLen > 0 && outLen < sizeof(buffer)) {
+        client->text(buffer, outLen);
+    }
+}
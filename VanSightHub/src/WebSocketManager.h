@@ -0,0 +1,106 @@
+#ifndef WEB_SOCKET_MANAGER_H
+#define WEB_SOCKET_MANAGER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <ESPAsyncWebServer.h>
+#include <functional>
+
+/**
+ * @brief WebSocket push channel for the hub dashboard
+ *
+ * Serves the dashboard from LittleFS and keeps every connected browser
+ * in sync over one WebSocket. State changes are encoded once and pushed
+ * to all clients; commands arrive on the same socket and are answered
+ * to the sender only.
+ */
+class WebSocketManager {
+public:
+    /**
+     * @brief Get singleton instance
+     */
+    static WebSocketManager& getInstance() {
+        static WebSocketManager instance;
+        return instance;
+    }
+    
+    /**
+     * @brief Start the HTTP server and the WebSocket endpoint
+     *
+     * @param path WebSocket endpoint path (default: "/ws")
+     * @return true if successful
+     */
+    bool begin(const char* path = "/ws");
+    
+    /**
+     * @brief Register handler for commands received on the socket
+     *
+     * The handler gets the sending client's id and the raw JSON command,
+     * and fills the response that is sent back to that browser.
+     */
+    void onCommand(std::function<void(uint32_t clientId, const uint8_t* data, size_t len, JsonDocument& response)> handler);
+    
+    /**
+     * @brief Register handler that serves the pre-serialized status frame
+     *
+     * Used to bring a freshly connected browser up to date. The handler
+     * copies the frame into buffer and returns its length.
+     */
+    void onStatusFrameRequest(std::function<size_t(char* buffer, size_t size)> handler);
+    
+    /**
+     * @brief Push a single relay state to all browsers
+     */
+    void broadcastRelayState(uint8_t relayNum, bool state);
+    
+    /**
+     * @brief Push several relay changes to all browsers in one frame
+     *
+     * @param changed Relays that changed (bit 0 = relay 1)
+     * @param state Full relay mask after the change
+     */
+    void broadcastRelayDelta(uint16_t changed, uint16_t state);
+    
+    /**
+     * @brief Push sensor readings to all browsers
+     *
+     * @param levels Level percentages (count elements)
+     * @param resistances Resistances in ohms (count elements)
+     * @param count Number of sensors
+     */
+    void broadcastSensors(const int levels[], const float resistances[], int count);
+    
+    /**
+     * @brief Encode a document once and push it to all browsers
+     */
+    void broadcast(const JsonDocument& doc);
+    
+    /**
+     * @brief Drop stale clients (call periodically from loop)
+     */
+    void cleanupClients();
+    
+    /**
+     * @brief Get number of connected browsers
+     */
+    size_t getClientCount() const;
+    
+private:
+    WebSocketManager();
+    WebSocketManager(const WebSocketManager&) = delete;
+    WebSocketManager& operator=(const WebSocketManager&) = delete;
+    
+    AsyncWebServer _server;
+    AsyncWebSocket* _ws;
+    bool _initialized;
+    
+    std::function<void(uint32_t, const uint8_t*, size_t, JsonDocument&)> _commandHandler;
+    std::function<size_t(char*, size_t)> _statusFrameHandler;
+    
+    void handleEvent(AsyncWebSocketClient* client, AwsEventType type, void* arg, uint8_t* data, size_t len);
+    void handleCommand(AsyncWebSocketClient* client, const uint8_t* data, size_t len);
+    
+    static const size_t FRAME_BUFFER_SIZE = 768;
+};
+
+#endif // WEB_SOCKET_MANAGER_H
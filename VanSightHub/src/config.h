@@ -10,6 +10,14 @@ const int RELAY_PINS[16] = {
     25, 26, 27, 14, 12, 13 // Relays 11-16
 };
 
+// Relay drive polarity: false = pin HIGH switches the relay ON
+const bool RELAY_ACTIVE_LOW = false;
+
+// Relay state journal (restored at boot after a power loss)
+const bool RELAY_RESTORE_ON_BOOT = true;
+const uint32_t RELAY_JOURNAL_DEBOUNCE_MS = 3000;       // Mask must be stable this long before saving
+const uint32_t RELAY_JOURNAL_MIN_INTERVAL_MS = 30000;  // At most one NVS write per interval
+
 // ============================================================================
 // LEVEL SENSOR PIN DEFINITIONS (ADC inputs)
 // ============================================================================
@@ -21,6 +29,8 @@ const int SENSOR_PINS[3] = {
 
 // ============================================================================
 // SENSOR CALIBRATION CONSTANTS
+// Used until a sensor has a calibration table; tables are captured at runtime
+// with the calibrate_point command and stored in NVS
 // ============================================================================
 // Sensor 1: 0-190Ω range
 const float SENSOR1_MIN_RESISTANCE = 0.0;
@@ -47,6 +57,48 @@ const float SUPPLY_VOLTAGE = 3.3;         // ESP32 ADC reference voltage
 // ADC resolution
 const int ADC_RESOLUTION = 4095;  // 12-bit ADC
 
+// Continuous (DMA) sampling of all sensor channels
+// Published reading rate per channel = ADC_SAMPLE_RATE_HZ / (sensors * ADC_OVERSAMPLING)
+const uint32_t ADC_SAMPLE_RATE_HZ = 20000;  // Total conversions/s (ESP32 minimum is 20kHz)
+const uint16_t ADC_OVERSAMPLING = 256;      // Conversions averaged (decimated) into one reading
+
+// Per-sensor filter chain on raw ADC values: median -> EMA -> slew limit (0 disables a stage)
+const uint8_t SENSOR_MEDIAN_WINDOW = 5;     // Samples in the median window (max 9)
+const uint8_t SENSOR_EMA_SHIFT = 3;         // EMA alpha = 1/8
+const uint16_t SENSOR_SLEW_LIMIT = 40;      // Max raw step per filtered reading
+
+// Level change events
+const uint8_t SENSOR_DEADBAND = 2;          // Minimum level change (%) that is broadcast
+const uint8_t SENSOR_HYSTERESIS = 1;        // Extra change (%) needed to reverse direction
+const unsigned long SENSOR_POLL_INTERVAL_MS = 1000;      // Poll when no readings are signalled
+const unsigned long SENSOR_EVENT_MIN_INTERVAL_MS = 200;  // Limit for reading-driven evaluation
+
+// ============================================================================
+// SENSOR HISTORY
+// ============================================================================
+const uint32_t HISTORY_FULL_INTERVAL_S = 10;   // Full-resolution bucket size
+const uint16_t HISTORY_FULL_POINTS = 360;      // 1 hour at full resolution (RAM only)
+const uint16_t HISTORY_MINUTE_POINTS = 1440;   // 24 hours of minute averages
+const uint16_t HISTORY_HOUR_POINTS = 720;      // 30 days of hourly averages
+
+// ============================================================================
+// TELEMETRY
+// ============================================================================
+const uint32_t TELEMETRY_INTERVAL_MS = 10000;
+const uint32_t TELEMETRY_MIN_FREE_HEAP = 24576;     // Warn below this free heap (bytes)
+const uint32_t TELEMETRY_MIN_LARGEST_BLOCK = 8192;  // Warn when fragmented below this block size
+const uint16_t TELEMETRY_MIN_STACK_FREE = 512;      // Warn when a task has less stack left
+const uint8_t TELEMETRY_QUEUE_FILL_PERCENT = 75;    // Warn when a queue is this full
+
+// ============================================================================
+// COMMAND RATE LIMITS
+// ============================================================================
+// Token bucket per client and lane; the critical lane (all off) is never limited
+const uint16_t RATE_LIMIT_CONTROL_PER_S = 5;    // Sustained relay / scene commands per second
+const uint16_t RATE_LIMIT_CONTROL_BURST = 10;   // Back-to-back relay / scene commands
+const uint16_t RATE_LIMIT_QUERY_PER_S = 10;     // Sustained status reads per second
+const uint16_t RATE_LIMIT_QUERY_BURST = 20;     // Back-to-back status reads
+
 // ============================================================================
 // ESP-NOW CONFIGURATION
 // ============================================================================
@@ -4,35 +4,88 @@
 #include "SensorController.h"
 #include "CommandHandler.h"
 #include "BuzzerManager.h"
+#include "StatusStore.h"
+#include "HistoryStore.h"
+#include "SceneStore.h"
+#include "RelayJournal.h"
+#include "RelayTimerWheel.h"
+#include "CommandExecutor.h"
+#include "RateLimiter.h"
+#include "HubScheduler.h"
+#include "WebSocketManager.h"
 #include "config.h"
+#include <WiFi.h>
 
 using namespace VanSight;
-RelayController relayController(RELAY_PINS, 16);
+RelayController relayController(RELAY_PINS, 16, RELAY_ACTIVE_LOW);
 SensorController sensorController(3);
-CommandHandler commandHandler(relayController, sensorController);
+StatusStore statusStore(16, 3);
+HistoryStore historyStore(3);
+SceneStore sceneStore;
+RelayJournal relayJournal(RELAY_JOURNAL_DEBOUNCE_MS, RELAY_JOURNAL_MIN_INTERVAL_MS);
+RelayTimerWheel relayTimers;
+CommandHandler commandHandler(relayController, sensorController, statusStore, historyStore, sceneStore, relayTimers);
+HubScheduler scheduler;
+
+// cmd_exec, async_tcp and loop all change relays; publishing takes turns
+SemaphoreHandle_t relayPublishMutex = nullptr;
+
+// Scheduler events
+#define EVT_SENSOR_READINGS  (1u << 0)   // Fresh averaged ADC readings
+#define EVT_SENSORS_CHANGED  (1u << 1)   // A reported level changed
 
 void initSensors();
+void initWiFi();
+void initScheduler();
+void initTelemetry();
+void initRateLimits();
 
-AllStatusData readAllStatus();
+RelayMask readRelayMask();
+void updateRelayMask(RelayMask mask);
+bool sampleSensors();
+void broadcastSensors();
+RelayMask publishRelayChanges(CommandType source = CMD_UNKNOWN);
 
 void setup()
 {
+    relayPublishMutex = xSemaphoreCreateMutex();
+    
+    // Restore relays first, before the serial delay and the radios
+    RelayMask restored = relayJournal.restore();
+    relayController.begin(RELAY_RESTORE_ON_BOOT ? restored : 0);
+    
     Serial.begin(115200);
     delay(1000);
     
     Serial.println("\n=== VanSightHub - ESP-NOW Server ===\n");
     
+    statusStore.begin();
+    historyStore.begin();
+    sceneStore.begin();
+    relayTimers.begin(historyStore.now());
+    
     // Initialize Buzzer
     BuzzerManager::getInstance().begin(4); // Pin 4
     BuzzerManager::getInstance().beep(100); // Startup beep
     
-    // Initialize relays
-    Serial.println("Initializing relays...");
-    relayController.begin();
-    Serial.printf("✓ %d relays initialized\n\n", relayController.getCount());
+    // Publish the restored relay states
+    updateRelayMask(readRelayMask());
+    Serial.printf("✓ %d relays initialized (restored 0x%04X)\n\n", relayController.getCount(), readRelayMask());
+    
+    // Scheduled relay actions run from loop()
+    relayTimers.onExpire([](uint8_t relayNum, TimerAction action) {
+        switch (action) {
+            case TIMER_RELAY_ON:     relayController.turnOn(relayNum); break;
+            case TIMER_RELAY_TOGGLE: relayController.toggle(relayNum); break;
+            default:                 relayController.turnOff(relayNum); break;
+        }
+        publishRelayChanges();
+    });
     
     // Initialize sensors
     initSensors();
+    sampleSensors();
+    initScheduler();
     
     // Initialize CommandManager as Server (BLE)
     if (!BleCommandManager::getInstance().beginServer("VanSightHub")) {
@@ -40,118 +93,234 @@ void setup()
         return;
     }
     
-    // Register relay toggle handler
-    BleCommandManager::getInstance().onToggleRelay([](uint8_t relayNum) -> bool {
-        Serial.printf("Toggle relay %d\n", relayNum);
-        
-        // Beep on command received
-        BuzzerManager::getInstance().beep(50);
-        
-        // Toggle relay
-        relayController.toggle(relayNum);
-        bool newState = relayController.getState(relayNum);
-        
-        // Broadcast to all clients
-        BleCommandManager::getInstance().sendRelayState(relayNum, newState);
-        
-        return newState;
+    // Run BLE commands on the executor task, not in the BLE write callback
+    CommandExecutor::getInstance().begin([](const Command& cmd) {
+        BleCommandManager::getInstance().executeCommand(cmd);
+    });
+    initTelemetry();
+    initRateLimits();
+    BleCommandManager::getInstance().setCommandDispatcher([](const Command& cmd) -> bool {
+        // One BLE link at a time: the link is the peer
+        JsonDocument busy;
+        if (!RateLimiter::getInstance().admit(RateLimiter::peerId(PEER_BLE, 0), cmd.type, busy)) {
+            BleCommandManager::getInstance().sendDocument(busy);
+            return true;
+        }
+        if (CommandExecutor::getInstance().submit(cmd, busy)) {
+            return true;
+        }
+        // A dropped command gets its busy reply; an empty one runs here
+        if (!busy.isNull()) {
+            BleCommandManager::getInstance().sendDocument(busy);
+            return true;
+        }
+        return false;
     });
     
-    // Register all relays off handler
-    BleCommandManager::getInstance().onAllRelaysOff([]() {
-        Serial.println("All relays OFF");
-        
-        // Beep on command received
-        BuzzerManager::getInstance().beepPattern(2, 50, 100);
-        
-        // Turn off all relays
-        for (int i = 1; i <= relayController.getCount(); i++) {
-            relayController.turnOff(i);
+    // One command set for every transport (BLE, ESP-NOW, WebSocket)
+    CommandRegistry& registry = CommandRegistry::getInstance();
+    commandHandler.registerCommands(registry);
+    registry.onDispatched([](CommandType type) {
+        // Handlers only drive the relays; publish what changed once here
+        RelayMask changed = publishRelayChanges(type);
+        if (type == CMD_ALL_RELAYS_OFF) {
+            BuzzerManager::getInstance().beepPattern(2, 50, 100);
+        } else if (changed) {
+            BuzzerManager::getInstance().beep(50);
         }
-        auto status = readAllStatus();
-        BleCommandManager::getInstance().sendAllStatus(status.relayStates, status.sensorLevels);
     });
     
-    // Register status request handler
-    BleCommandManager::getInstance().onStatusRequest([]() -> AllStatusData {
+    // Serve status requests from the cached frame
+    BleCommandManager::getInstance().onStatusFrameRequest([](char* buffer, size_t size) -> size_t {
         Serial.println("Status requested");
         
         // Beep on command received
         BuzzerManager::getInstance().beep(30);
         
-        return readAllStatus();
+        return statusStore.copyFrame(CODEC_BLE, buffer, size);
     });
     
+    // Initialize WiFi and the dashboard WebSocket
+    initWiFi();
+    WebSocketManager::getInstance().onCommand([](uint32_t clientId, const uint8_t* data, size_t len, JsonDocument& response) {
+        commandHandler.processCommand(data, len, response, RateLimiter::peerId(PEER_WEB, clientId));
+    });
+    WebSocketManager::getInstance().onStatusFrameRequest([](char* buffer, size_t size) -> size_t {
+        return statusStore.copyFrame(CODEC_WEB, buffer, size);
+    });
+    WebSocketManager::getInstance().begin("/ws");
+    
     Serial.println("\\n=== System Ready ===");
     Serial.printf("Waiting for clients (max %d)...\\n\\n", ESP_NOW_MAX_TOTAL_PEER_NUM);
 }
 
-AllStatusData readAllStatus()
+RelayMask readRelayMask()
 {
-    AllStatusData data{};
+    return relayController.getMask();
+}
 
-    // Get relay states
-    for (int i = 0; i < VanSight::MAX_RELAYS; i++) {
-        data.relayStates[i] = relayController.getState(i + 1);
+// Callers hold relayPublishMutex (setup runs before any other task)
+void updateRelayMask(RelayMask mask)
+{
+    if (statusStore.setRelayMask(mask)) {
+        historyStore.recordRelays(mask);
+        relayJournal.record(mask);
     }
+}
 
-    // Get sensor levels
-    for (int i = 0; i < VanSight::MAX_SENSORS; i++) {
-        data.sensorLevels[i] = sensorController.readLevel(i + 1);
+bool sampleSensors()
+{
+    bool changed = false;
+    
+    SensorSnapshot snapshot;
+    sensorController.readAll(snapshot);
+    
+    for (int i = 1; i <= snapshot.count; i++) {
+        const SensorReading& reading = snapshot.sensors[i - 1];
+        if (reading.raw < 0) continue;
+        
+        int previous = statusStore.getSensorLevel(i);
+        int level = sensorController.updateStableLevel(i, reading.level);
+        
+        if (statusStore.setSensor(i, level, reading.resistance)) {
+            changed = true;
+            Serial.printf("[Sensor] Sensor %d changed: %d -> %d\n", i, previous, level);
+        }
     }
+    
+    return changed;
+}
 
-    return data;
+RelayMask publishRelayChanges(CommandType source)
+{
+    // Compare the live mask with the published one under the lock, so a
+    // slower task never stores, journals or sends an older mask over a newer one
+    xSemaphoreTake(relayPublishMutex, portMAX_DELAY);
+    RelayMask before = statusStore.getRelayMask();
+    RelayMask after = readRelayMask();
+    RelayMask changed = before ^ after;
+    if (!changed) {
+        xSemaphoreGive(relayPublishMutex);
+        return 0;
+    }
+    
+    updateRelayMask(after);
+    
+    // One relay: send a single state, several: one delta frame
+    if ((changed & (changed - 1)) == 0) {
+        int relayNum = __builtin_ctz(changed) + 1;
+        bool state = (after & changed) != 0;
+        BleCommandManager::getInstance().sendRelayState(relayNum, state, source);
+        WebSocketManager::getInstance().broadcastRelayState(relayNum, state);
+    } else {
+        BleCommandManager::getInstance().sendRelayDelta(changed, after, source);
+        WebSocketManager::getInstance().broadcastRelayDelta(changed, after);
+    }
+    xSemaphoreGive(relayPublishMutex);
+    
+    return changed;
 }
 
+void broadcastSensors()
+{
+    Serial.println("[Sensor] Sending sensor update to clients...");
+    
+    if (BleCommandManager::getInstance().isConnected()) {
+        char frame[512];
+        size_t len = statusStore.copyFrame(CODEC_BLE, frame, sizeof(frame));
+        BleCommandManager::getInstance().sendFrame(frame, len);
+    }
+    
+    int levels[VanSight::MAX_SENSORS];
+    float resistances[VanSight::MAX_SENSORS];
+    for (int i = 0; i < sensorController.getCount(); i++) {
+        levels[i] = statusStore.getSensorLevel(i + 1);
+        resistances[i] = statusStore.getSensorResistance(i + 1);
+    }
+    WebSocketManager::getInstance().broadcastSensors(levels, resistances, sensorController.getCount());
+}
 
 void loop()
 {
-    static unsigned long lastSensorCheck = 0;
-    static int lastSensorLevels[VanSight::MAX_SENSORS] = {-1, -1, -1}; // Initialize with invalid values
-    unsigned long now = millis();
+    // Sleeps until the next job is due or an event is signalled
+    scheduler.runOnce();
+}
 
-    // Check sensors every 5 seconds
-    if (now - lastSensorCheck >= 5000) {
-        lastSensorCheck = now;
+void initScheduler()
+{
+    scheduler.begin();
+    
+    // Evaluate sensors whenever the sampler has fresh readings; the period
+    // covers analogRead fallback mode and a stalled sampler
+    sensorController.onReadings([]() {
+        scheduler.signal(EVT_SENSOR_READINGS);
+    });
+    scheduler.addJob("sensors", []() {
+        // Keep the store fresh even with nobody listening
+        if (sampleSensors()) {
+            scheduler.signal(EVT_SENSORS_CHANGED);
+        }
         
-        if (BleCommandManager::getInstance().isConnected()) {
-            bool sensorChanged = false;
-            int currentSensorLevels[VanSight::MAX_SENSORS];
-            
-            // Read current sensor levels
-            for (int i = 0; i < VanSight::MAX_SENSORS; i++) {
-                currentSensorLevels[i] = sensorController.readLevel(i + 1);
-                
-                // Check if sensor value changed
-                if (currentSensorLevels[i] != lastSensorLevels[i]) {
-                    sensorChanged = true;
-                    Serial.printf("[Sensor] Sensor %d changed: %d -> %d\n", 
-                                  i, lastSensorLevels[i], currentSensorLevels[i]);
-                }
-            }
-            
-            // If any sensor changed, send update to clients
-            if (sensorChanged) {
-                Serial.println("[Sensor] Sending sensor update to clients...");
-                
-                // Get current relay states
-                int relayStates[VanSight::MAX_RELAYS];
-                for (int i = 0; i < VanSight::MAX_RELAYS; i++) {
-                    relayStates[i] = relayController.getState(i + 1);
-                }
-                
-                // Send all status with updated sensor levels
-                BleCommandManager::getInstance().sendAllStatus(relayStates, currentSensorLevels);
-                
-                // Update last known sensor levels
-                for (int i = 0; i < VanSight::MAX_SENSORS; i++) {
-                    lastSensorLevels[i] = currentSensorLevels[i];
-                }
-            }
+        int levels[VanSight::MAX_SENSORS];
+        for (int i = 0; i < sensorController.getCount(); i++) {
+            levels[i] = statusStore.getSensorLevel(i + 1);
         }
-    }
+        historyStore.recordLevels(levels);
+    }, SENSOR_POLL_INTERVAL_MS, EVT_SENSOR_READINGS, SENSOR_EVENT_MIN_INTERVAL_MS);
+    
+    // Only real transitions are broadcast
+    scheduler.addJob("broadcast", broadcastSensors, 0, EVT_SENSORS_CHANGED);
+    
+    scheduler.addJob("timers", []() {
+        relayTimers.tick(historyStore.now());
+    }, 1000);
+    
+    scheduler.addJob("journal", []() {
+        relayJournal.update();
+        historyStore.flushRelays();
+    }, 1000);
     
-    delay(100);
+    scheduler.addJob("housekeeping", []() {
+        WebSocketManager::getInstance().cleanupClients();
+    }, 5000);
+    
+    scheduler.addJob("telemetry", []() {
+        Telemetry::getInstance().sample();
+        CommandExecutor::getInstance().printStats();
+        scheduler.printStats();
+    }, TELEMETRY_INTERVAL_MS);
+}
+
+void initTelemetry()
+{
+    TelemetryThresholds thresholds = {
+        TELEMETRY_MIN_FREE_HEAP,
+        TELEMETRY_MIN_LARGEST_BLOCK,
+        TELEMETRY_MIN_STACK_FREE,
+        TELEMETRY_QUEUE_FILL_PERCENT
+    };
+    Telemetry& telemetry = Telemetry::getInstance();
+    telemetry.begin(TELEMETRY_INTERVAL_MS, thresholds);
+    
+    // Looked up by name at the first sample
+    telemetry.watchTask("loopTask");
+    telemetry.watchTask("cmd_exec");
+    telemetry.watchTask("adc_sampler");
+    telemetry.watchTask("async_tcp");
+    telemetry.watchTask("BTC_TASK");
+    
+    CommandExecutor& executor = CommandExecutor::getInstance();
+    for (int lane = 0; lane < LANE_COUNT; lane++) {
+        telemetry.watchQueue(CommandExecutor::laneName((CommandLane)lane), executor.getQueue((CommandLane)lane));
+    }
+}
+
+void initRateLimits()
+{
+    RateLimit control = { RATE_LIMIT_CONTROL_PER_S, RATE_LIMIT_CONTROL_BURST };
+    RateLimit query = { RATE_LIMIT_QUERY_PER_S, RATE_LIMIT_QUERY_BURST };
+    RateLimiter::getInstance().setLimit(LANE_CONTROL, control);
+    RateLimiter::getInstance().setLimit(LANE_QUERY, query);
 }
 
 void initSensors()
@@ -166,6 +335,29 @@ void initSensors()
     sensorController.addSensor(2, SENSOR_PINS[2], SENSOR23_MIN_RESISTANCE, SENSOR23_MAX_RESISTANCE, REFERENCE_RESISTOR);
     
     sensorController.begin();
+    sensorController.loadCalibration();
+    
+    FilterConfig filter = { SENSOR_MEDIAN_WINDOW, SENSOR_EMA_SHIFT, SENSOR_SLEW_LIMIT };
+    sensorController.setFilter(0, filter);
+    sensorController.setChangeThresholds(0, SENSOR_DEADBAND, SENSOR_HYSTERESIS);
+    
+    // Sample in the background; analogRead remains the fallback
+    sensorController.beginContinuous(ADC_SAMPLE_RATE_HZ, ADC_OVERSAMPLING);
     
     Serial.printf("✓ %d level sensors initialized\\n\\n", sensorController.getCount());
-}
\ No newline at end of file
+}
+
+void initWiFi()
+{
+    Serial.println("Initializing WiFi...");
+    
+    if (WIFI_AP_MODE) {
+        WiFi.mode(WIFI_AP);
+        WiFi.softAP(WIFI_SSID, WIFI_PASSWORD);
+        Serial.printf("✓ AP started: %s (%s)\n\n", WIFI_SSID, WiFi.softAPIP().toString().c_str());
+    } else {
+        WiFi.mode(WIFI_STA);
+        WiFi.begin(WIFI_STA_SSID, WIFI_STA_PASSWORD);
+        Serial.printf("✓ Connecting to %s...\n\n", WIFI_STA_SSID);
+    }
+}
@@ -0,0 +1,131 @@
+#include <unity.h>
+#include "RelayController.h"
+#include "RelayOutput.h"
+
+using namespace VanSight;
+
+// Ten relays, like the van wiring; bits above relay 10 must never be driven
+static const int RELAY_COUNT = 10;
+static const RelayMask VALID_MASK = 0x03FF;
+
+static MockRelayOutput* output;
+static RelayController* relays;
+
+void setUp() {
+    output = new MockRelayOutput();
+    relays = new RelayController(*output, RELAY_COUNT);
+    relays->begin(0);
+}
+
+void tearDown() {
+    delete relays;
+    delete output;
+}
+
+// ============================================================================
+// BEGIN
+// ============================================================================
+
+void test_begin_drives_initial_mask() {
+    MockRelayOutput restored;
+    RelayController controller(restored, RELAY_COUNT);
+    controller.begin(0xF005);
+    
+    TEST_ASSERT_TRUE(restored.started);
+    TEST_ASSERT_EQUAL_HEX32(0x0005, restored.lastMask);
+    TEST_ASSERT_EQUAL_HEX16(0x0005, controller.getMask());
+    TEST_ASSERT_EQUAL_UINT32(0, restored.writeCount);
+}
+
+// ============================================================================
+// BULK WRITES
+// ============================================================================
+
+void test_apply_writes_whole_mask_once() {
+    relays->apply(0x0123);
+    
+    TEST_ASSERT_EQUAL_UINT32(1, output->writeCount);
+    TEST_ASSERT_EQUAL_HEX32(0x0123, output->lastMask);
+    TEST_ASSERT_TRUE(relays->getState(1));
+    TEST_ASSERT_TRUE(relays->getState(9));
+    TEST_ASSERT_FALSE(relays->getState(3));
+}
+
+void test_apply_drops_relays_out_of_range() {
+    relays->apply(0xFC01);
+    
+    TEST_ASSERT_EQUAL_HEX32(0x0001, output->lastMask);
+    TEST_ASSERT_EQUAL_HEX16(0x0001, relays->getMask());
+}
+
+void test_set_changes_only_masked_relays() {
+    relays->apply(0x00F0);
+    
+    // Relays 1-2 on, relays 5-6 off, the rest untouched
+    RelayMask before = relays->set(0x0033, 0x0003);
+    
+    TEST_ASSERT_EQUAL_HEX16(0x00F0, before);
+    TEST_ASSERT_EQUAL_UINT32(2, output->writeCount);
+    TEST_ASSERT_EQUAL_HEX32(0x00C3, output->lastMask);
+}
+
+void test_set_ignores_values_outside_mask() {
+    relays->set(0x0001, 0x0301);
+    
+    TEST_ASSERT_EQUAL_HEX32(0x0001, output->lastMask);
+}
+
+void test_all_on_and_off() {
+    relays->allOn();
+    TEST_ASSERT_EQUAL_HEX32(VALID_MASK, output->lastMask);
+    
+    relays->allOff();
+    TEST_ASSERT_EQUAL_HEX32(0x0000, output->lastMask);
+    TEST_ASSERT_EQUAL_UINT32(2, output->writeCount);
+}
+
+// ============================================================================
+// SINGLE RELAYS
+// ============================================================================
+
+void test_toggle_flips_one_relay() {
+    relays->apply(0x0010);
+    
+    TEST_ASSERT_TRUE(relays->toggle(1));
+    TEST_ASSERT_EQUAL_HEX32(0x0011, output->lastMask);
+    
+    TEST_ASSERT_TRUE(relays->toggle(5));
+    TEST_ASSERT_EQUAL_HEX32(0x0001, output->lastMask);
+    TEST_ASSERT_EQUAL_UINT32(3, output->writeCount);
+}
+
+void test_turn_on_and_off() {
+    TEST_ASSERT_TRUE(relays->turnOn(10));
+    TEST_ASSERT_EQUAL_HEX32(0x0200, output->lastMask);
+    
+    TEST_ASSERT_TRUE(relays->turnOff(10));
+    TEST_ASSERT_EQUAL_HEX32(0x0000, output->lastMask);
+}
+
+void test_invalid_relay_is_not_written() {
+    TEST_ASSERT_FALSE(relays->toggle(0));
+    TEST_ASSERT_FALSE(relays->turnOn(RELAY_COUNT + 1));
+    TEST_ASSERT_FALSE(relays->turnOff(-1));
+    TEST_ASSERT_FALSE(relays->getState(RELAY_COUNT + 1));
+    
+    TEST_ASSERT_EQUAL_UINT32(0, output->writeCount);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_begin_drives_initial_mask);
+    RUN_TEST(test_apply_writes_whole_mask_once);
+    RUN_TEST(test_apply_drops_relays_out_of_range);
+    RUN_TEST(test_set_changes_only_masked_relays);
+    RUN_TEST(test_set_ignores_values_outside_mask);
+    RUN_TEST(test_all_on_and_off);
+    RUN_TEST(test_toggle_flips_one_relay);
+    RUN_TEST(test_turn_on_and_off);
+    RUN_TEST(test_invalid_relay_is_not_written);
+    return UNITY_END();
+}
@@ -0,0 +1,63 @@
+#ifndef ADC_TRACE_H
+#define ADC_TRACE_H
+
+#include <stdint.h>
+
+/**
+ * @brief Raw readings of one level sensor channel (12-bit codes)
+ *
+ * One reading per decimated sampler frame (about 26 Hz with three sensors
+ * and 256x oversampling): 150 readings at rest, 150 while the tank fills
+ * and 150 at rest again. Slosh and ADC noise ride on every reading and
+ * relay switching adds single and double sample spikes.
+ */
+static const int32_t ADC_TRACE[] = {
+    1796, 1799, 1803, 1799, 1798, 1802, 1794, 1809, 1807, 1806, 1805, 1808,
+    1808, 1804, 1800, 1801, 1802, 1798, 1804, 1805, 1795, 1804, 1798, 1798,
+    1797, 1795, 1795, 1797, 1791, 1800, 1790, 1796, 1796, 1791, 1794, 1793,
+    1791, 1792, 1805, 1803, 2556, 1760, 1801, 1802, 1804, 1802, 1796, 1805,
+    1793, 1805, 1801, 1800, 1808, 1799, 1810, 1803, 1807, 1803, 1802, 1814,
+    1812, 1804, 1804, 1800, 1806, 1808, 1808, 1797, 1798, 1792, 1798, 1798,
+    1791, 1791, 1801, 1795, 1799, 1796, 1793, 1797, 1799, 1797, 1795, 1797,
+    1800, 1800, 1806, 1801, 1802, 1799, 1796, 1796, 1802, 1806, 1808, 1799,
+    1799, 1179, 1801, 1802, 1801, 1797, 1807, 1805, 1801, 1811, 1801, 1807,
+    1798, 1802, 1791, 1799, 1797, 1795, 1800, 1800, 1791, 1798, 1800, 1796,
+    1804, 1793, 1793, 1797, 1797, 1806, 1800, 1803, 2676, 1796, 1804, 1801,
+    1805, 1802, 1806, 1801, 1801, 1804, 1802, 1807, 1808, 1808, 1799, 1800,
+    1806, 1806, 1804, 1803, 1798, 1808, 1803, 1807, 1804, 1806, 1809, 1816,
+    1813, 1823, 1818, 1815, 1825, 1826, 1828, 1843, 1835, 1830, 1839, 1844,
+    1843, 1856, 1850, 1850, 1853, 1854, 1862, 1868, 1872, 1867, 1878, 1873,
+    1878, 1890, 1883, 1898, 1899, 1902, 1895, 1910, 1906, 1905, 1913, 1913,
+    1922, 1916, 1919, 1919, 1925, 1930, 1923, 1929, 1939, 1937, 1937, 1945,
+    1940, 1946, 1948, 1946, 1943, 1953, 1959, 1953, 2662, 1970, 1964, 1971,
+    1975, 1971, 1984, 1981, 1989, 1992, 1993, 1990, 1997, 2000, 2004, 2008,
+    2018, 2018, 2022, 2024, 2022, 2027, 2029, 2022, 2031, 2037, 2035, 2039,
+    2042, 2043, 2043, 2047, 2063, 2052, 2051, 2050, 2059, 2054, 2058, 2062,
+    2067, 2072, 2072, 2070, 2079, 2076, 2090, 2091, 2098, 2099, 2101, 2101,
+    2096, 2106, 2109, 2112, 2116, 2117, 2121, 2129, 2130, 2129, 2133, 2140,
+    2140, 2145, 2143, 2149, 2150, 2154, 2149, 2153, 2159, 2165, 2154, 2158,
+    2169, 2169, 2178, 2171, 2176, 2181, 2177, 2183, 2184, 2192, 2186, 2192,
+    2200, 2198, 2199, 2206, 2199, 2200, 2197, 2202, 2201, 2200, 2206, 2199,
+    2202, 2200, 2200, 2203, 2204, 2199, 2204, 2207, 2206, 2204, 2191, 2195,
+    2206, 2200, 2199, 2206, 2194, 2201, 2201, 2203, 2202, 2197, 2196, 2193,
+    2189, 2197, 2201, 2195, 2199, 2196, 2194, 2199, 2190, 2207, 2202, 2204,
+    2197, 2193, 2191, 2200, 2209, 2202, 2199, 2204, 2209, 2203, 2210, 2205,
+    2205, 2215, 2195, 2196, 2207, 1505, 1555, 2203, 2202, 2206, 2196, 2202,
+    2198, 2203, 2198, 2203, 2196, 2191, 2195, 2196, 2200, 2196, 2194, 2190,
+    2193, 2196, 2193, 2202, 2205, 2195, 2192, 2199, 2195, 2199, 2202, 2195,
+    2199, 2203, 2201, 2201, 2202, 2201, 2204, 2202, 2212, 2206, 2202, 2200,
+    2204, 2210, 3109, 2211, 2204, 2196, 2213, 2200, 2202, 2200, 2199, 2201,
+    2192, 2202, 2200, 2193, 2196, 2198, 2195, 2193, 2195, 2197, 2197, 2194,
+    2198, 2201, 2200, 2200, 2202, 2196, 2204, 2200, 2198, 2192, 2195, 2191,
+    2202, 2198, 2205, 2194, 2206, 2202,
+};
+
+static const int ADC_TRACE_LENGTH = sizeof(ADC_TRACE) / sizeof(ADC_TRACE[0]);
+
+// Segment boundaries and the resting levels of the trace
+static const int TRACE_FILL_START = 150;
+static const int TRACE_FILL_END = 300;
+static const int32_t TRACE_REST_BEFORE = 1800;
+static const int32_t TRACE_REST_AFTER = 2200;
+
+#endif // ADC_TRACE_H
@@ -0,0 +1,161 @@
+#include <unity.h>
+#include <stdint.h>
+#include "config.h"
+#include "SensorFilter.h"
+#include "adc_trace.h"
+
+// Filter settings and detector thresholds the hub runs with
+static const FilterConfig HUB_FILTER = { SENSOR_MEDIAN_WINDOW, SENSOR_EMA_SHIFT, SENSOR_SLEW_LIMIT };
+
+// Readings the EMA needs to settle after the start of a segment
+static const int SETTLE = 30;
+
+static int32_t filtered[ADC_TRACE_LENGTH];
+
+static int32_t toLevel(int32_t raw) {
+    return (raw * 100 + ADC_RESOLUTION / 2) / ADC_RESOLUTION;
+}
+
+static int32_t absDiff(int32_t a, int32_t b) {
+    return a > b ? a - b : b - a;
+}
+
+void setUp() {
+    SensorFilter filter;
+    filter.configure(HUB_FILTER);
+    for (int i = 0; i < ADC_TRACE_LENGTH; i++) {
+        filtered[i] = filter.process(ADC_TRACE[i]);
+    }
+}
+
+void tearDown() {
+}
+
+// ============================================================================
+// FILTER CHAIN
+// ============================================================================
+
+void test_filter_rejects_spikes_at_rest() {
+    for (int i = SETTLE; i < TRACE_FILL_START; i++) {
+        TEST_ASSERT_INT32_WITHIN(10, TRACE_REST_BEFORE, filtered[i]);
+    }
+    for (int i = TRACE_FILL_END + SETTLE; i < ADC_TRACE_LENGTH; i++) {
+        TEST_ASSERT_INT32_WITHIN(10, TRACE_REST_AFTER, filtered[i]);
+    }
+}
+
+void test_filter_respects_slew_limit() {
+    for (int i = 1; i < ADC_TRACE_LENGTH; i++) {
+        TEST_ASSERT_TRUE(absDiff(filtered[i], filtered[i - 1]) <= SENSOR_SLEW_LIMIT);
+    }
+}
+
+void test_filter_tracks_fill() {
+    // The fill is a steady ramp; the output trails it by a few codes
+    for (int i = TRACE_FILL_START + SETTLE; i < TRACE_FILL_END; i++) {
+        int32_t expected = TRACE_REST_BEFORE
+            + (TRACE_REST_AFTER - TRACE_REST_BEFORE) * (i - TRACE_FILL_START) / (TRACE_FILL_END - TRACE_FILL_START);
+        TEST_ASSERT_INT32_WITHIN(30, expected - 15, filtered[i]);
+    }
+}
+
+void test_filter_first_sample_passes_through() {
+    SensorFilter filter;
+    filter.configure(HUB_FILTER);
+    TEST_ASSERT_EQUAL_INT32(ADC_TRACE[0], filter.process(ADC_TRACE[0]));
+    
+    filter.reset();
+    TEST_ASSERT_EQUAL_INT32(3000, filter.process(3000));
+}
+
+// ============================================================================
+// CHANGE DETECTOR
+// ============================================================================
+
+void test_detector_deadband() {
+    ChangeDetector detector;
+    detector.configure(SENSOR_DEADBAND, SENSOR_HYSTERESIS);
+    
+    TEST_ASSERT_TRUE(detector.update(50));
+    TEST_ASSERT_FALSE(detector.update(51));
+    TEST_ASSERT_FALSE(detector.update(49));
+    TEST_ASSERT_TRUE(detector.update(52));
+    TEST_ASSERT_EQUAL_INT32(52, detector.getReported());
+}
+
+void test_detector_hysteresis_on_reversal() {
+    ChangeDetector detector;
+    detector.configure(SENSOR_DEADBAND, SENSOR_HYSTERESIS);
+    
+    detector.update(50);
+    TEST_ASSERT_TRUE(detector.update(52));
+    
+    // Going back down needs deadband + hysteresis
+    TEST_ASSERT_FALSE(detector.update(50));
+    TEST_ASSERT_TRUE(detector.update(49));
+    
+    // Same direction again needs only the deadband
+    TEST_ASSERT_TRUE(detector.update(47));
+    TEST_ASSERT_EQUAL_INT32(47, detector.getReported());
+}
+
+void test_detector_does_not_flap_on_boundary() {
+    ChangeDetector detector;
+    detector.configure(SENSOR_DEADBAND, SENSOR_HYSTERESIS);
+    
+    detector.update(50);
+    detector.update(52);
+    
+    int events = 0;
+    const int32_t readings[] = { 51, 50, 51, 52, 51, 50, 51, 52, 53, 52 };
+    for (int32_t level : readings) {
+        events += detector.update(level) ? 1 : 0;
+    }
+    TEST_ASSERT_EQUAL_INT(0, events);
+}
+
+// ============================================================================
+// TRACE REPLAY
+// ============================================================================
+
+void test_trace_events() {
+    ChangeDetector detector;
+    detector.configure(SENSOR_DEADBAND, SENSOR_HYSTERESIS);
+    
+    int32_t previous = -1;
+    int fillEvents = 0;
+    for (int i = 0; i < ADC_TRACE_LENGTH; i++) {
+        int32_t level = toLevel(filtered[i]);
+        if (!detector.update(level)) {
+            continue;
+        }
+        
+        if (i == 0) {
+            // Seeds the reported level
+        } else if (i < TRACE_FILL_START || i >= TRACE_FILL_END + SETTLE) {
+            TEST_FAIL_MESSAGE("Change event while the tank is at rest");
+        } else {
+            // The fill only ever raises the level, by at least the deadband
+            TEST_ASSERT_TRUE(level - previous >= SENSOR_DEADBAND);
+            fillEvents++;
+        }
+        previous = level;
+    }
+    
+    int32_t fillLevels = toLevel(TRACE_REST_AFTER) - toLevel(TRACE_REST_BEFORE);
+    TEST_ASSERT_INT_WITHIN(1, fillLevels / SENSOR_DEADBAND, fillEvents);
+    TEST_ASSERT_INT32_WITHIN(SENSOR_DEADBAND - 1, toLevel(TRACE_REST_AFTER), detector.getReported());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_filter_rejects_spikes_at_rest);
+    RUN_TEST(test_filter_respects_slew_limit);
+    RUN_TEST(test_filter_tracks_fill);
+    RUN_TEST(test_filter_first_sample_passes_through);
+    RUN_TEST(test_detector_deadband);
+    RUN_TEST(test_detector_hysteresis_on_reversal);
+    RUN_TEST(test_detector_does_not_flap_on_boundary);
+    RUN_TEST(test_trace_events);
+    return UNITY_END();
+}
@@ -21,6 +21,7 @@
 #include "protocol/VanSightProtocol.h"
 #include "protocol/CommandParser.h"
 #include "protocol/ResponseBuilder.h"
+#include "protocol/CommandRegistry.h"
 
 // Communication
 #include "communication/ESPNowManager.h"
@@ -28,4 +29,9 @@
 #include "communication/BleManager.h"
 #include "communication/BleCommandManager.h"
 
+// Metrics
+#include "metrics/LatencyHistogram.h"
+#include "metrics/LatencyMetrics.h"
+#include "metrics/Telemetry.h"
+
 #endif // VANSIGHT_LIB_H
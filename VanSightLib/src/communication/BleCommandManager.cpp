@@ -1,6 +1,8 @@
 #include "BleCommandManager.h"
 #include "../protocol/CommandParser.h"
 #include "../protocol/ResponseBuilder.h"
+#include "../protocol/CommandRegistry.h"
+#include "../metrics/LatencyMetrics.h"
 #include <ArduinoJson.h>
 
 namespace VanSight {
@@ -17,10 +19,15 @@ BleCommandManager::BleCommandManager()
       _initialized(false),
       _dataReceivedCallback(nullptr),
       _relayChangedCallback(nullptr),
+      _relaysChangedCallback(nullptr),
       _connectionCallback(nullptr),
       _toggleRelayHandler(nullptr),
       _allRelaysOffHandler(nullptr),
-      _statusRequestHandler(nullptr)
+      _statusRequestHandler(nullptr),
+      _statusFrameHandler(nullptr),
+      _sceneApplyHandler(nullptr),
+      _commandDispatcher(nullptr),
+      _activeCommand(CMD_UNKNOWN)
 {
 }
 
@@ -128,6 +135,55 @@ void BleCommandManager::toggleRelay(uint8_t relayNum)
         len++;
     }
     
+    _ble->sendData((uint8_t*)buffer, len);
+    LatencyMetrics::getInstance().stamp(CMD_RELAY_TOGGLE, STAGE_CLIENT_TX);
+}
+
+void BleCommandManager::setRelay(uint8_t relayNum, bool state)
+{
+    if (!_ble || _role != BleRole::CLIENT) {
+        return;
+    }
+    
+    JsonDocument doc;
+    doc["cmd"] = "relay_set";
+    doc["relay"] = relayNum;
+    doc["state"] = state ? "on" : "off";
+    
+    char buffer[256];
+    size_t len = serializeJson(doc, buffer);
+    
+    // Append newline as delimiter
+    if (len < sizeof(buffer) - 1) {
+        buffer[len] = '\n';
+        buffer[len + 1] = '\0';
+        len++;
+    }
+    
+    _ble->sendData((uint8_t*)buffer, len);
+}
+
+void BleCommandManager::setRelays(RelayMask mask, RelayMask values)
+{
+    if (!_ble || _role != BleRole::CLIENT || mask == 0) {
+        return;
+    }
+    
+    JsonDocument doc;
+    doc["cmd"] = "relays_set";
+    doc["mask"] = mask;
+    doc["values"] = values & mask;
+    
+    char buffer[256];
+    size_t len = serializeJson(doc, buffer);
+    
+    // Append newline as delimiter
+    if (len < sizeof(buffer) - 1) {
+        buffer[len] = '\n';
+        buffer[len + 1] = '\0';
+        len++;
+    }
+    
     _ble->sendData((uint8_t*)buffer, len);
 }
 
@@ -151,6 +207,7 @@ void BleCommandManager::allRelaysOff()
     }
     
     _ble->sendData((uint8_t*)buffer, len);
+    LatencyMetrics::getInstance().stamp(CMD_ALL_RELAYS_OFF, STAGE_CLIENT_TX);
 }
 
 void BleCommandManager::requestStatus()
@@ -173,6 +230,31 @@ void BleCommandManager::requestStatus()
     }
     
     _ble->sendData((uint8_t*)buffer, len);
+    LatencyMetrics::getInstance().stamp(CMD_ALL_STATUS, STAGE_CLIENT_TX);
+}
+
+void BleCommandManager::applyScene(const char* name)
+{
+    if (!_ble || _role != BleRole::CLIENT || !name) {
+        return;
+    }
+    
+    JsonDocument doc;
+    doc["cmd"] = "scene_apply";
+    doc["name"] = name;
+    
+    char buffer[256];
+    size_t len = serializeJson(doc, buffer);
+    
+    // Append newline as delimiter
+    if (len < sizeof(buffer) - 1) {
+        buffer[len] = '\n';
+        buffer[len + 1] = '\0';
+        len++;
+    }
+    
+    _ble->sendData((uint8_t*)buffer, len);
+    LatencyMetrics::getInstance().stamp(CMD_SCENE_APPLY, STAGE_CLIENT_TX);
 }
 
 // ============================================================================
@@ -189,6 +271,11 @@ void BleCommandManager::onRelayChanged(std::function<void(uint8_t, bool)> callba
     _relayChangedCallback = callback;
 }
 
+void BleCommandManager::onRelaysChanged(std::function<void(RelayMask, RelayMask, CommandType)> callback)
+{
+    _relaysChangedCallback = callback;
+}
+
 void BleCommandManager::onConnectionChanged(std::function<void(bool)> callback)
 {
     _connectionCallback = callback;
@@ -213,11 +300,31 @@ void BleCommandManager::onStatusRequest(std::function<AllStatusData()> handler)
     _statusRequestHandler = handler;
 }
 
+void BleCommandManager::onStatusFrameRequest(std::function<size_t(char*, size_t)> handler)
+{
+    _statusFrameHandler = handler;
+}
+
+void BleCommandManager::onSceneApply(std::function<bool(const char*)> handler)
+{
+    _sceneApplyHandler = handler;
+}
+
+void BleCommandManager::setCommandDispatcher(std::function<bool(const Command&)> dispatcher)
+{
+    _commandDispatcher = dispatcher;
+}
+
+void BleCommandManager::executeCommand(const Command& cmd)
+{
+    handleCommand(cmd);
+}
+
 // ============================================================================
 // SERVER MODE - SEND UPDATES
 // ============================================================================
 
-void BleCommandManager::sendRelayState(uint8_t relayNum, bool state)
+void BleCommandManager::sendRelayState(uint8_t relayNum, bool state, CommandType source)
 {
     if (!_ble || _role != BleRole::SERVER) {
         return;
@@ -226,6 +333,9 @@ void BleCommandManager::sendRelayState(uint8_t relayNum, bool state)
     // Build JSON directly for BLE
     JsonDocument doc;
     doc["status"] = "ok";
+    if (source != CMD_UNKNOWN) {
+        doc["cmd"] = commandTypeToString(source);
+    }
     
     JsonObject data = doc.createNestedObject("data");
     data["relay"] = relayNum;
@@ -244,6 +354,7 @@ void BleCommandManager::sendRelayState(uint8_t relayNum, bool state)
     Serial.printf("[BleCmd] Sending relay state: %d bytes\n", len);
     
     _ble->sendData((uint8_t*)buffer, len);
+    markResponseSent();
 }
 
 void BleCommandManager::sendAllStatus(const int relayStates[MAX_RELAYS], const int sensorLevels[MAX_SENSORS])
@@ -286,6 +397,63 @@ void BleCommandManager::sendAllStatus(const int relayStates[MAX_RELAYS], const i
     Serial.printf("[BleCmd] JSON: %s\n", buffer);
     
     _ble->sendData((uint8_t*)buffer, len);
+    markResponseSent();
+}
+
+void BleCommandManager::sendRelayDelta(RelayMask changed, RelayMask state, CommandType source)
+{
+    if (!_ble || _role != BleRole::SERVER || changed == 0) {
+        return;
+    }
+    
+    JsonDocument doc;
+    doc["status"] = "ok";
+    if (source != CMD_UNKNOWN) {
+        doc["cmd"] = commandTypeToString(source);
+    }
+    
+    JsonObject data = doc["data"].to<JsonObject>();
+    data["changed"] = changed;
+    data["mask"] = state;
+    
+    char buffer[128];
+    size_t len = serializeJson(doc, buffer, sizeof(buffer) - 1);
+    buffer[len++] = '\n';
+    
+    _ble->sendData((uint8_t*)buffer, len);
+    markResponseSent();
+}
+
+void BleCommandManager::sendFrame(const char* frame, size_t len)
+{
+    if (!_ble || _role != BleRole::SERVER || len == 0) {
+        return;
+    }
+    
+    _ble->sendData((const uint8_t*)frame, len);
+    markResponseSent();
+}
+
+void BleCommandManager::sendDocument(const JsonDocument& doc)
+{
+    char buffer[1024];
+    size_t len = serializeJson(doc, buffer, sizeof(buffer) - 1);
+    if (len == 0 || len >= sizeof(buffer) - 1) {
+        const char error[] = "{\"status\":\"error\",\"message\":\"Response too large\"}\n";
+        sendFrame(error, sizeof(error) - 1);
+        return;
+    }
+    
+    buffer[len++] = '\n';
+    sendFrame(buffer, len);
+}
+
+void BleCommandManager::markResponseSent()
+{
+    CommandType active = _activeCommand;
+    if (active != CMD_UNKNOWN) {
+        LatencyMetrics::getInstance().stamp(active, STAGE_HUB_TX);
+    }
 }
 
 // ============================================================================
@@ -320,6 +488,18 @@ void BleCommandManager::handleData(const uint8_t* data, size_t len)
         
         Serial.printf("[BleCmd] Full Message: %s\n", message.c_str());
         
+        if (_role == BleRole::SERVER) {
+            // Server receives commands; the parser keeps the request for the registry
+            Command cmd;
+            if (CommandParser::parse((const uint8_t*)message.c_str(), message.length(), cmd)) {
+                dispatchCommand(cmd);
+            } else {
+                const char error[] = "{\"status\":\"error\",\"message\":\"Invalid command\"}\n";
+                sendFrame(error, sizeof(error) - 1);
+            }
+            continue;
+        }
+        
         // Parse JSON
         JsonDocument doc;
         DeserializationError error = deserializeJson(doc, message);
@@ -329,65 +509,66 @@ void BleCommandManager::handleData(const uint8_t* data, size_t len)
             continue;
         }
         
-        if (_role == BleRole::SERVER) {
-            // Server receives commands
-            Command cmd;
-            // Note: CommandParser expects raw bytes, but we have a JSON object now
-            // We need to adapt CommandParser or parse manually here
-            // Since we switched to JSON commands, let's parse manually for now
-            
-            if (doc.containsKey("cmd")) {
-                const char* cmdType = doc["cmd"];
+        // Client receives responses; "cmd" names the command they answer
+        const char* status = doc["status"];
+        CommandType source = stringToCommandType(doc["cmd"].as<const char*>());
+        if (status && strcmp(status, "ok") == 0) {
+            // Parse response data
+            if (doc.containsKey("data")) {
+                JsonObject dataObj = doc["data"];
                 
-                if (strcmp(cmdType, "relay_toggle") == 0) {
-                    cmd.type = CMD_RELAY_TOGGLE;
-                    cmd.params.relay.relayNum = doc["relay"];
-                    handleCommand(cmd);
-                }
-                else if (strcmp(cmdType, "all_relays_off") == 0) {
-                    cmd.type = CMD_ALL_RELAYS_OFF;
-                    handleCommand(cmd);
-                }
-                else if (strcmp(cmdType, "all_status") == 0) {
-                    cmd.type = CMD_ALL_STATUS;
-                    handleCommand(cmd);
+                // Check if it's all status
+                if (dataObj.containsKey("relays") && dataObj.containsKey("sensors")) {
+                    AllStatusData allData;
+                    
+                    JsonArray relays = dataObj["relays"];
+                    for (size_t i = 0; i < MAX_RELAYS && i < relays.size(); i++) {
+                        allData.relayStates[i] = relays[i];
+                    }
+                    
+                    JsonArray sensors = dataObj["sensors"];
+                    for (size_t i = 0; i < MAX_SENSORS && i < sensors.size(); i++) {
+                        JsonObject sensor = sensors[i];
+                        allData.sensorLevels[i] = sensor["level"];
+                    }
+                    
+                    LatencyMetrics::getInstance().stamp(CMD_ALL_STATUS, STAGE_CLIENT_RX);
+                    if (_dataReceivedCallback) {
+                        _dataReceivedCallback(allData);
+                    }
                 }
-            }
-        } else {
-            // Client receives responses
-            const char* status = doc["status"];
-            if (status && strcmp(status, "ok") == 0) {
-                // Parse response data
-                if (doc.containsKey("data")) {
-                    JsonObject dataObj = doc["data"];
+                // Check if it's a multi-relay delta
+                else if (dataObj.containsKey("changed") && dataObj.containsKey("mask")) {
+                    RelayMask changed = dataObj["changed"];
+                    RelayMask state = dataObj["mask"];
                     
-                    // Check if it's all status
-                    if (dataObj.containsKey("relays") && dataObj.containsKey("sensors")) {
-                        AllStatusData allData;
-                        
-                        JsonArray relays = dataObj["relays"];
-                        for (size_t i = 0; i < MAX_RELAYS && i < relays.size(); i++) {
-                            allData.relayStates[i] = relays[i];
-                        }
-                        
-                        JsonArray sensors = dataObj["sensors"];
-                        for (size_t i = 0; i < MAX_SENSORS && i < sensors.size(); i++) {
-                            JsonObject sensor = sensors[i];
-                            allData.sensorLevels[i] = sensor["level"];
-                        }
-                        
-                        if (_dataReceivedCallback) {
-                            _dataReceivedCallback(allData);
+                    LatencyMetrics::getInstance().stamp(source, STAGE_CLIENT_RX);
+                    
+                    if (_relaysChangedCallback) {
+                        _relaysChangedCallback(changed, state, source);
+                    } else if (_relayChangedCallback) {
+                        for (uint8_t i = 0; i < MAX_RELAYS; i++) {
+                            if (changed & (1u << i)) {
+                                _relayChangedCallback(i + 1, (state >> i) & 1);
+                            }
                         }
                     }
-                    // Check if it's single relay
-                    else if (dataObj.containsKey("relay") && dataObj.containsKey("state")) {
-                        uint8_t relayNum = dataObj["relay"];
-                        bool state = dataObj["state"];
-                        
-                        if (_relayChangedCallback) {
-                            _relayChangedCallback(relayNum, state);
-                        }
+                }
+                // Check if it's single relay
+                else if (dataObj.containsKey("relay") && dataObj.containsKey("state")) {
+                    uint8_t relayNum = dataObj["relay"];
+                    // Registry handlers answer "on"/"off", broadcasts a bool
+                    JsonVariant stateValue = dataObj["state"];
+                    bool state = stateValue.is<const char*>()
+                        ? strcmp(stateValue.as<const char*>(), "on") == 0
+                        : stateValue.as<bool>();
+                    
+                    LatencyMetrics::getInstance().stamp(source, STAGE_CLIENT_RX);
+                    if (_relaysChangedCallback && relayNum >= 1 && relayNum <= MAX_RELAYS) {
+                        RelayMask bit = (RelayMask)(1u << (relayNum - 1));
+                        _relaysChangedCallback(bit, state ? bit : 0, source);
+                    } else if (_relayChangedCallback) {
+                        _relayChangedCallback(relayNum, state);
                     }
                 }
             }
@@ -395,16 +576,56 @@ void BleCommandManager::handleData(const uint8_t* data, size_t len)
     }
 }
 
+void BleCommandManager::dispatchCommand(const Command& cmd)
+{
+    LatencyMetrics::getInstance().stamp(cmd.type, STAGE_HUB_RX);
+    
+    // Leave the BLE callback as soon as possible when a dispatcher is set
+    if (_commandDispatcher && _commandDispatcher(cmd)) {
+        return;
+    }
+    handleCommand(cmd);
+}
+
 void BleCommandManager::handleCommand(const Command& cmd)
 {
-    Response response;
-    response.status = STATUS_OK;
+    LatencyMetrics::getInstance().stamp(cmd.type, STAGE_HANDLER_START);
+    _activeCommand = cmd.type;
+    
+    // Cached status frame: a memcpy instead of building a document
+    bool answered = false;
+    if (cmd.type == CMD_ALL_STATUS && _statusFrameHandler) {
+        char frame[512];
+        size_t len = _statusFrameHandler(frame, sizeof(frame));
+        if (len > 0) {
+            sendFrame(frame, len);
+            answered = true;
+        }
+    }
+    
+    // Registry dispatches stamp the handler stages too; the first stamp counts
+    if (!answered) {
+        if (CommandRegistry::getInstance().has(cmd.type)) {
+            JsonDocument result;
+            CommandRegistry::getInstance().dispatch(cmd, result);
+            sendDocument(result);
+        } else {
+            handleLegacyCommand(cmd);
+        }
+    }
     
+    _activeCommand = CMD_UNKNOWN;
+    LatencyMetrics::getInstance().stamp(cmd.type, STAGE_HANDLER_END);
+}
+
+void BleCommandManager::handleLegacyCommand(const Command& cmd)
+{
+    // Per-command callbacks, used when no registry handler is registered
     switch (cmd.type) {
         case CMD_RELAY_TOGGLE:
             if (_toggleRelayHandler) {
                 bool newState = _toggleRelayHandler(cmd.params.relay.relayNum);
-                sendRelayState(cmd.params.relay.relayNum, newState);
+                sendRelayState(cmd.params.relay.relayNum, newState, cmd.type);
             }
             break;
             
@@ -421,6 +642,13 @@ void BleCommandManager::handleCommand(const Command& cmd)
             }
             break;
             
+        case CMD_SCENE_APPLY:
+            if (_sceneApplyHandler && !_sceneApplyHandler(cmd.params.scene.name)) {
+                const char error[] = "{\"status\":\"error\",\"message\":\"Unknown scene\"}\n";
+                sendFrame(error, sizeof(error) - 1);
+            }
+            break;
+            
         default:
             break;
     }
@@ -6,6 +6,7 @@
 #include "BleManager.h"
 #include "../protocol/VanSightProtocol.h"
 #include "../config/VanSightConfig.h"
+#include <ArduinoJson.h>
 
 namespace VanSight {
 
@@ -60,6 +61,22 @@ public:
      */
     void toggleRelay(uint8_t relayNum);
     
+    /**
+     * @brief Set a relay to a given state
+     * 
+     * Idempotent: a retried or duplicated frame leaves the relay as is.
+     * @param relayNum Relay number (1-16)
+     * @param state Target state
+     */
+    void setRelay(uint8_t relayNum, bool state);
+    
+    /**
+     * @brief Set several relays in one frame
+     * @param mask Relays to set (bit 0 = relay 1)
+     * @param values Target states of the relays in mask
+     */
+    void setRelays(RelayMask mask, RelayMask values);
+    
     /**
      * @brief Turn off all relays
      */
@@ -70,6 +87,12 @@ public:
      */
     void requestStatus();
     
+    /**
+     * @brief Apply a scene stored on the hub
+     * @param name Scene name (max 15 characters)
+     */
+    void applyScene(const char* name);
+    
     // ========================================================================
     // CLIENT MODE - RECEIVE DATA
     // ========================================================================
@@ -84,6 +107,16 @@ public:
      */
     void onRelayChanged(std::function<void(uint8_t relayNum, bool state)> callback);
     
+    /**
+     * @brief Register callback for relay changes with their origin
+     * 
+     * Called for every relay frame (single relay or delta) with the relays
+     * that changed, their states and the command that caused the change
+     * (CMD_UNKNOWN for timers and other hub-side changes). Without this
+     * callback changes are reported through onRelayChanged() per relay.
+     */
+    void onRelaysChanged(std::function<void(RelayMask changed, RelayMask state, CommandType source)> callback);
+    
     /**
      * @brief Register callback for connection state
      */
@@ -92,6 +125,9 @@ public:
     // ========================================================================
     // SERVER MODE - HANDLE COMMANDS
     // ========================================================================
+    // Commands with a CommandRegistry handler are dispatched there and the
+    // handler's response is sent back; the callbacks below only serve
+    // commands without one.
     
     /**
      * @brief Register handler for relay toggle command
@@ -110,19 +146,71 @@ public:
      */
     void onStatusRequest(std::function<AllStatusData()> handler);
     
+    /**
+     * @brief Register handler that serves a pre-serialized status frame
+     * 
+     * Takes precedence over onStatusRequest(). The handler copies a
+     * newline-terminated status frame into buffer and returns its length
+     * (0 to fall back to onStatusRequest()).
+     */
+    void onStatusFrameRequest(std::function<size_t(char* buffer, size_t size)> handler);
+    
+    /**
+     * @brief Register handler for scene apply command
+     * @param handler Function that applies the scene, false if unknown
+     */
+    void onSceneApply(std::function<bool(const char* name)> handler);
+    
+    /**
+     * @brief Hand parsed commands to a dispatcher instead of running them
+     * 
+     * By default commands run inside the BLE write callback. A dispatcher
+     * can queue them and later run them with executeCommand() from its own
+     * task. If it returns false the command runs inline.
+     */
+    void setCommandDispatcher(std::function<bool(const Command& cmd)> dispatcher);
+    
+    /**
+     * @brief Run a parsed command through the registered handlers
+     */
+    void executeCommand(const Command& cmd);
+    
     // ========================================================================
     // SERVER MODE - SEND UPDATES
     // ========================================================================
     
     /**
      * @brief Send relay state to client
+     * @param source Command that caused the change, sent as "cmd"
+     *               (CMD_UNKNOWN: not sent)
      */
-    void sendRelayState(uint8_t relayNum, bool state);
+    void sendRelayState(uint8_t relayNum, bool state, CommandType source = CMD_UNKNOWN);
     
     /**
      * @brief Send all status to client
      */
     void sendAllStatus(const int relayStates[MAX_RELAYS], const int sensorLevels[MAX_SENSORS]);
+    
+    /**
+     * @brief Send several relay changes to client in one frame
+     * @param changed Relays that changed (bit 0 = relay 1)
+     * @param state Full relay mask after the change
+     * @param source Command that caused the change, sent as "cmd"
+     *               (CMD_UNKNOWN: not sent)
+     */
+    void sendRelayDelta(RelayMask changed, RelayMask state, CommandType source = CMD_UNKNOWN);
+    
+    /**
+     * @brief Send an already encoded, newline-terminated frame to client
+     */
+    void sendFrame(const char* frame, size_t len);
+    
+    /**
+     * @brief Encode a response document and send it to client
+     * 
+     * Sends an error frame instead if the document does not fit.
+     */
+    void sendDocument(const JsonDocument& doc);
 
 private:
     BleCommandManager();
@@ -139,6 +227,7 @@ private:
     // Client callbacks
     std::function<void(const AllStatusData&)> _dataReceivedCallback;
     std::function<void(uint8_t, bool)> _relayChangedCallback;
+    std::function<void(RelayMask, RelayMask, CommandType)> _relaysChangedCallback;
     std::function<void(bool)> _connectionCallback;
     
     // Buffer for packet reassembly
@@ -148,11 +237,18 @@ private:
     std::function<bool(uint8_t)> _toggleRelayHandler;
     std::function<void()> _allRelaysOffHandler;
     std::function<AllStatusData()> _statusRequestHandler;
+    std::function<size_t(char*, size_t)> _statusFrameHandler;
+    std::function<bool(const char*)> _sceneApplyHandler;
+    std::function<bool(const Command&)> _commandDispatcher;
+    volatile CommandType _activeCommand;   // Command whose handler is running
     
     // Internal handlers
     void handleCommand(const Command& cmd);
+    void handleLegacyCommand(const Command& cmd);
+    void dispatchCommand(const Command& cmd);
     void handleResponse(const Response& response);
     void handleData(const uint8_t* data, size_t len);
+    void markResponseSent();
     
     // Helper methods
     Response createRelayResponse(uint8_t relayNum, bool state);
@@ -31,6 +31,9 @@ BleManager::~BleManager()
     if (_client) {
         delete _client;
     }
+    if (_serverDevice) {
+        delete _serverDevice;
+    }
 }
 
 bool BleManager::begin()
@@ -132,12 +135,15 @@ bool BleManager::initClient()
         if (device.haveServiceUUID() && 
             device.isAdvertisingService(BLEUUID(VANSIGHT_SERVICE_UUID))) {
             log("[BLE] Found VanSight server!");
-            _serverDevice = new BLEAdvertisedDevice(device);
+            setServerDevice(device);
             connectToServer();
             break;
         }
     }
     
+    // Scan results keep a copy of every advertiser
+    scan->clearResults();
+    
     if (!_serverDevice) {
         log("[BLE] VanSight server not found");
     }
@@ -259,7 +265,17 @@ void BleManager::handleConnectionChange(bool connected)
         log("[BLE] Attempting reconnect in 5s...");
         delay(5000);
         BLEDevice::getScan()->start(5, false);
+        BLEDevice::getScan()->clearResults();
+    }
+}
+
+void BleManager::setServerDevice(const BLEAdvertisedDevice& device)
+{
+    // Every scan hit used to allocate a new copy and leak the previous one
+    if (_serverDevice) {
+        delete _serverDevice;
     }
+    _serverDevice = new BLEAdvertisedDevice(device);
 }
 
 void BleManager::log(const char* format, ...)
@@ -314,7 +330,7 @@ void BleManager::AdvertisedDeviceCallbacks::onResult(BLEAdvertisedDevice adverti
         
         _manager->log("[BLE] Found VanSight server!");
         BLEDevice::getScan()->stop();
-        _manager->_serverDevice = new BLEAdvertisedDevice(advertisedDevice);
+        _manager->setServerDevice(advertisedDevice);
         _manager->connectToServer();
     } else {
         _manager->log("[BLE] Not VanSight server (no matching service UUID)");
@@ -149,6 +149,7 @@ private:
     bool initClient();
     bool connectToServer();
     void handleConnectionChange(bool connected);
+    void setServerDevice(const BLEAdvertisedDevice& device);
     void log(const char* format, ...);
     
     friend class ServerCallbacks;
@@ -1,4 +1,7 @@
 #include "CommandManager.h"
+#include "../protocol/CommandRegistry.h"
+#include "../metrics/LatencyMetrics.h"
+#include <ArduinoJson.h>
 
 namespace VanSight {
 
@@ -42,6 +45,7 @@ bool CommandManager::beginServer(uint8_t channel)
     
     // Register command callback
     _espnow->onCommandReceived([this](const Command& cmd, const uint8_t* mac) {
+        LatencyMetrics::getInstance().stamp(cmd.type, STAGE_HUB_RX);
         handleCommand(cmd, mac);
     });
     
@@ -93,6 +97,34 @@ void CommandManager::toggleRelay(uint8_t relayNum)
     _espnow->sendCommand(cmd);
 }
 
+void CommandManager::setRelay(uint8_t relayNum, bool state)
+{
+    if (!_espnow || _role != ESPNowRole::CLIENT) {
+        return;
+    }
+    
+    Command cmd;
+    cmd.type = CMD_RELAY_SET;
+    cmd.params.relaySet.relayNum = relayNum;
+    cmd.params.relaySet.state = state;
+    
+    _espnow->sendCommand(cmd);
+}
+
+void CommandManager::setRelays(RelayMask mask, RelayMask values)
+{
+    if (!_espnow || _role != ESPNowRole::CLIENT || mask == 0) {
+        return;
+    }
+    
+    Command cmd;
+    cmd.type = CMD_RELAYS_SET;
+    cmd.params.relays.mask = mask;
+    cmd.params.relays.values = values & mask;
+    
+    _espnow->sendCommand(cmd);
+}
+
 void CommandManager::allRelaysOff()
 {
     if (!_espnow || _role != ESPNowRole::CLIENT) {
@@ -192,6 +224,23 @@ int CommandManager::getClientCount() const
 
 void CommandManager::handleCommand(const Command& cmd, const uint8_t* senderMac)
 {
+    // Registered commands answer with the handler's JSON response
+    if (CommandRegistry::getInstance().has(cmd.type)) {
+        JsonDocument result;
+        CommandRegistry::getInstance().dispatch(cmd, result);
+        
+        char buffer[MAX_PAYLOAD_SIZE];
+        size_t len = serializeJson(result, buffer, sizeof(buffer));
+        if (len == 0 || len >= sizeof(buffer)) {
+            // ESP-NOW frames are small; large results only fit over BLE
+            const char error[] = "{\"status\":\"error\",\"message\":\"Response too large\"}";
+            _espnow->sendFrame(error, sizeof(error) - 1, senderMac);
+            return;
+        }
+        _espnow->sendFrame(buffer, len, senderMac);
+        return;
+    }
+    
     Response response;
     response.status = STATUS_OK;
     
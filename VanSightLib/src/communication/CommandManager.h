@@ -64,6 +64,22 @@ public:
      */
     void toggleRelay(uint8_t relayNum);
     
+    /**
+     * @brief Set a relay to a given state
+     * 
+     * Idempotent: a retried or duplicated frame leaves the relay as is.
+     * @param relayNum Relay number (1-16)
+     * @param state Target state
+     */
+    void setRelay(uint8_t relayNum, bool state);
+    
+    /**
+     * @brief Set several relays in one frame
+     * @param mask Relays to set (bit 0 = relay 1)
+     * @param values Target states of the relays in mask
+     */
+    void setRelays(RelayMask mask, RelayMask values);
+    
     /**
      * @brief Turn off all relays
      */
@@ -91,6 +107,9 @@ public:
     // ========================================================================
     // SERVER MODE - HANDLE COMMANDS
     // ========================================================================
+    // Commands with a CommandRegistry handler are dispatched there and the
+    // handler's response is sent back; the callbacks below only serve
+    // commands without one.
     
     /**
      * @brief Register handler for relay toggle command
@@ -112,6 +112,14 @@ bool ESPNowManager::sendCommand(const Command& cmd)
         case CMD_RELAY_TOGGLE:
             doc["relay"] = cmd.params.relay.relayNum;
             break;
+        case CMD_RELAY_SET:
+            doc["relay"] = cmd.params.relaySet.relayNum;
+            doc["state"] = cmd.params.relaySet.state ? "on" : "off";
+            break;
+        case CMD_RELAYS_SET:
+            doc["mask"] = cmd.params.relays.mask;
+            doc["values"] = cmd.params.relays.values;
+            break;
         case CMD_SENSOR_READ:
             doc["sensor"] = cmd.params.sensor.sensorNum;
             break;
@@ -161,6 +169,20 @@ bool ESPNowManager::sendResponse(const Response& response, const uint8_t* target
     return sendData((uint8_t*)buffer, len, target);
 }
 
+bool ESPNowManager::sendFrame(const char* frame, size_t len, const uint8_t* targetMac)
+{
+    if (!_initialized || _role != ESPNowRole::SERVER || len == 0 || len > MAX_PAYLOAD_SIZE) {
+        return false;
+    }
+    
+    const uint8_t* target = targetMac ? targetMac : _lastSenderMac;
+    if (!esp_now_is_peer_exist(target)) {
+        addPeer(target);
+    }
+    
+    return sendData((const uint8_t*)frame, len, target);
+}
+
 int ESPNowManager::broadcastResponse(const Response& response)
 {
     if (!_initialized) {
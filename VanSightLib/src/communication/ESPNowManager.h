@@ -65,6 +65,15 @@ namespace VanSight
          */
         bool sendResponse(const Response& response, const uint8_t* targetMac = nullptr);
 
+        /**
+         * @brief Send an already encoded JSON response (Server mode)
+         * @param frame Encoded response (max MAX_PAYLOAD_SIZE bytes)
+         * @param len Frame length
+         * @param targetMac Target MAC address (uses last sender if nullptr)
+         * @return true if sent successfully
+         */
+        bool sendFrame(const char* frame, size_t len, const uint8_t* targetMac = nullptr);
+
         /**
          * @brief Broadcast response to all registered clients (Server mode)
          * @param response Response to broadcast
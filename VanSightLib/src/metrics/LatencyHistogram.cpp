@@ -0,0 +1,84 @@
+#include "LatencyHistogram.h"
+
+namespace VanSight {
+    
+// Upper bucket limits in microseconds; the last bucket takes the rest
+static const uint32_t BUCKET_LIMITS[LatencyHistogram::BUCKET_COUNT - 1] = {
+    100, 200, 500,
+    1000, 2000, 5000,
+    10000, 20000, 50000,
+    100000, 200000, 500000,
+    1000000, 2000000, 5000000
+};
+    
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+    
+void LatencyHistogram::record(uint32_t us) {
+    int bucket = 0;
+    while (bucket < BUCKET_COUNT - 1 && us > BUCKET_LIMITS[bucket]) {
+        bucket++;
+    }
+    
+    _buckets[bucket]++;
+    _count++;
+    _sum += us;
+    if (us > _max) {
+        _max = us;
+    }
+}
+    
+void LatencyHistogram::reset() {
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        _buckets[i] = 0;
+    }
+    _count = 0;
+    _max = 0;
+    _sum = 0;
+}
+    
+uint32_t LatencyHistogram::percentile(uint8_t p) const {
+    if (_count == 0) {
+        return 0;
+    }
+    if (p > 100) {
+        p = 100;
+    }
+    
+    // Rank of the sample we are looking for (1-based, rounded up)
+    uint32_t rank = ((uint64_t)_count * p + 99) / 100;
+    if (rank == 0) {
+        rank = 1;
+    }
+    
+    uint32_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        seen += _buckets[i];
+        if (seen >= rank) {
+            // Never report more than was actually measured
+            uint32_t limit = bucketLimit(i);
+            return limit < _max ? limit : _max;
+        }
+    }
+    return _max;
+}
+    
+uint32_t LatencyHistogram::getBucket(int index) const {
+    if (index < 0 || index >= BUCKET_COUNT) {
+        return 0;
+    }
+    return _buckets[index];
+}
+    
+uint32_t LatencyHistogram::bucketLimit(int index) {
+    if (index < 0) {
+        return 0;
+    }
+    if (index >= BUCKET_COUNT - 1) {
+        return UINT32_MAX;
+    }
+    return BUCKET_LIMITS[index];
+}
+    
+} // namespace VanSight
@@ -0,0 +1,59 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <stdint.h>
+
+namespace VanSight {
+    
+/**
+ * @brief Fixed-bucket latency histogram in microseconds
+ *
+ * Buckets follow a 1-2-5 series from 100us to 5s plus one overflow
+ * bucket, so recording is a short scan and the memory footprint is
+ * constant. Percentiles are reported as the upper limit of the bucket
+ * they fall into (the maximum for the overflow bucket).
+ */
+class LatencyHistogram {
+public:
+    static const int BUCKET_COUNT = 16;
+    
+    LatencyHistogram();
+    
+    /**
+     * @brief Record one latency sample
+     * @param us Latency in microseconds
+     */
+    void record(uint32_t us);
+    
+    /**
+     * @brief Clear all samples
+     */
+    void reset();
+    
+    /**
+     * @brief Get latency at or below which p percent of samples fall
+     * @param p Percentile (1-100)
+     * @return uint32_t Bucket upper limit in microseconds, 0 if empty
+     */
+    uint32_t percentile(uint8_t p) const;
+    
+    uint32_t getCount() const { return _count; }
+    uint32_t getMax() const { return _max; }
+    uint32_t getMean() const { return _count ? (uint32_t)(_sum / _count) : 0; }
+    uint32_t getBucket(int index) const;
+    
+    /**
+     * @brief Get the upper limit of a bucket (UINT32_MAX for overflow)
+     */
+    static uint32_t bucketLimit(int index);
+    
+private:
+    uint32_t _buckets[BUCKET_COUNT];
+    uint32_t _count;
+    uint32_t _max;
+    uint64_t _sum;
+};
+    
+} // namespace VanSight
+
+#endif // LATENCY_HISTOGRAM_H
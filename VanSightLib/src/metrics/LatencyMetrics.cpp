@@ -0,0 +1,117 @@
+#include "LatencyMetrics.h"
+#include <esp_timer.h>
+
+namespace VanSight {
+    
+LatencyMetrics& LatencyMetrics::getInstance()
+{
+    static LatencyMetrics instance;
+    return instance;
+}
+    
+LatencyMetrics::LatencyMetrics()
+    : _lock(portMUX_INITIALIZER_UNLOCKED)
+{
+    for (int i = 0; i < COMMAND_SLOTS; i++) {
+        _traces[i].origin = 0;
+        _traces[i].seen = 0;
+        _traces[i].active = false;
+    }
+}
+    
+void LatencyMetrics::stamp(CommandType type, LatencyStage stage)
+{
+    if ((int)type < 0 || (int)type >= COMMAND_SLOTS || stage >= STAGE_COUNT) {
+        return;
+    }
+    
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    uint16_t bit = 1u << stage;
+    
+    portENTER_CRITICAL(&_lock);
+    Trace& trace = _traces[type];
+    
+    if (stage == STAGE_UI_EVENT || stage == STAGE_HUB_RX) {
+        trace.origin = now;
+        trace.seen = bit;
+        trace.active = true;
+    } else if (trace.active && !(trace.seen & bit)) {
+        uint32_t elapsed = now - trace.origin;
+        if (elapsed > TRACE_TIMEOUT_US) {
+            trace.active = false;
+        } else {
+            trace.seen |= bit;
+            _histograms[type][stage].record(elapsed);
+            
+            const uint16_t hubEnd = (1u << STAGE_HANDLER_END) | (1u << STAGE_HUB_TX);
+            if (stage == STAGE_UI_APPLY || (trace.seen & hubEnd) == hubEnd) {
+                trace.active = false;
+            }
+        }
+    }
+    portEXIT_CRITICAL(&_lock);
+}
+    
+bool LatencyMetrics::getHistogram(CommandType type, LatencyStage stage, LatencyHistogram& out) const
+{
+    if ((int)type < 0 || (int)type >= COMMAND_SLOTS || stage >= STAGE_COUNT) {
+        return false;
+    }
+    
+    portENTER_CRITICAL(&_lock);
+    out = _histograms[type][stage];
+    portEXIT_CRITICAL(&_lock);
+    return true;
+}
+    
+void LatencyMetrics::reset()
+{
+    portENTER_CRITICAL(&_lock);
+    for (int i = 0; i < COMMAND_SLOTS; i++) {
+        _traces[i].active = false;
+        for (int s = 0; s < STAGE_COUNT; s++) {
+            _histograms[i][s].reset();
+        }
+    }
+    portEXIT_CRITICAL(&_lock);
+}
+    
+void LatencyMetrics::print() const
+{
+    Serial.println("[Metrics] Latency since trace origin (us)");
+    
+    for (int i = 0; i < COMMAND_SLOTS; i++) {
+        for (int s = 0; s < STAGE_COUNT; s++) {
+            LatencyHistogram histogram;
+            getHistogram((CommandType)i, (LatencyStage)s, histogram);
+            if (histogram.getCount() == 0) {
+                continue;
+            }
+            
+            Serial.printf("[Metrics] %-16s %-14s n=%-5u p50=%-8u p99=%-8u max=%u\n",
+                          commandTypeToString((CommandType)i),
+                          stageName((LatencyStage)s),
+                          histogram.getCount(),
+                          histogram.percentile(50),
+                          histogram.percentile(99),
+                          histogram.getMax());
+        }
+    }
+}
+    
+const char* LatencyMetrics::stageName(LatencyStage stage)
+{
+    switch (stage) {
+        case STAGE_UI_EVENT: return "ui_event";
+        case STAGE_CLIENT_TX: return "client_tx";
+        case STAGE_HUB_RX: return "hub_rx";
+        case STAGE_HANDLER_START: return "handler_start";
+        case STAGE_HANDLER_END: return "handler_end";
+        case STAGE_HUB_TX: return "hub_tx";
+        case STAGE_CLIENT_RX: return "client_rx";
+        case STAGE_UI_APPLY: return "ui_apply";
+        default: return "unknown";
+    }
+}
+    
+} // namespace VanSight
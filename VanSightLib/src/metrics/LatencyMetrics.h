@@ -0,0 +1,98 @@
+#ifndef LATENCY_METRICS_H
+#define LATENCY_METRICS_H
+
+#include <Arduino.h>
+#include "LatencyHistogram.h"
+#include "../protocol/VanSightProtocol.h"
+
+namespace VanSight {
+    
+/**
+ * @brief Points on the way of a command, in order
+ *
+ * Client and hub clocks are not synchronized, so each device measures
+ * its own part: the display from the UI event to the UI apply, the hub
+ * from RX to the end of the handler. Broadcasts go out from inside the
+ * handler and registry responses right after it, so STAGE_HUB_TX may come
+ * on either side of STAGE_HANDLER_END; a hub trace ends once both are in.
+ */
+enum LatencyStage {
+    STAGE_UI_EVENT = 0,     // Client: button event (trace origin)
+    STAGE_CLIENT_TX,        // Client: command written to the transport
+    STAGE_HUB_RX,           // Hub: command parsed (trace origin)
+    STAGE_HANDLER_START,    // Hub: handler starts (after any queueing)
+    STAGE_HANDLER_END,      // Hub: handler returned (trace end)
+    STAGE_HUB_TX,           // Hub: first response frame written
+    STAGE_CLIENT_RX,        // Client: response parsed
+    STAGE_UI_APPLY,         // Client: UI updated (trace end)
+    STAGE_COUNT
+};
+    
+/**
+ * @brief Per command type latency histograms
+ *
+ * One trace per command type is kept in flight. An origin stage starts
+ * a new trace; every later stage records the time elapsed since the
+ * origin into the histogram of that command type and stage, once per
+ * trace. Stages without an open trace (e.g. broadcasts nobody asked
+ * for) are ignored, and traces older than TRACE_TIMEOUT_US are dropped.
+ *
+ * All methods are safe to call from any task.
+ */
+class LatencyMetrics {
+public:
+    static const int COMMAND_SLOTS = CMD_COUNT;
+    static const uint32_t TRACE_TIMEOUT_US = 10000000;
+    
+    /**
+     * @brief Get singleton instance
+     */
+    static LatencyMetrics& getInstance();
+    
+    /**
+     * @brief Record that a command reached a stage
+     */
+    void stamp(CommandType type, LatencyStage stage);
+    
+    /**
+     * @brief Copy one histogram
+     * @return false if type or stage is out of range
+     */
+    bool getHistogram(CommandType type, LatencyStage stage, LatencyHistogram& out) const;
+    
+    /**
+     * @brief Clear all histograms and open traces
+     */
+    void reset();
+    
+    /**
+     * @brief Print count, p50, p99 and max of every non-empty histogram
+     */
+    void print() const;
+    
+    /**
+     * @brief Get the short name of a stage (e.g. "hub_rx")
+     */
+    static const char* stageName(LatencyStage stage);
+    
+private:
+    LatencyMetrics();
+    
+    // Prevent copying
+    LatencyMetrics(const LatencyMetrics&) = delete;
+    LatencyMetrics& operator=(const LatencyMetrics&) = delete;
+    
+    struct Trace {
+        uint32_t origin;    // esp_timer time in us (wraps after ~71 min)
+        uint16_t seen;      // Stages already recorded (bit per stage)
+        bool active;
+    };
+    
+    Trace _traces[COMMAND_SLOTS];
+    LatencyHistogram _histograms[COMMAND_SLOTS][STAGE_COUNT];
+    mutable portMUX_TYPE _lock;
+};
+    
+} // namespace VanSight
+
+#endif // LATENCY_METRICS_H
@@ -0,0 +1,277 @@
+#include "Telemetry.h"
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+
+namespace VanSight {
+    
+Telemetry& Telemetry::getInstance()
+{
+    static Telemetry instance;
+    return instance;
+}
+    
+Telemetry::Telemetry()
+    : _intervalMs(10000),
+      _lastSample(0),
+      _thresholds{ 16384, 8192, 512, 75 },
+      _taskCount(0),
+      _queueCount(0),
+      _lastTotalRunTime(0),
+      _lock(portMUX_INITIALIZER_UNLOCKED),
+      _warningCallback(nullptr)
+{
+    memset(&_record, 0, sizeof(_record));
+}
+    
+void Telemetry::begin(uint32_t intervalMs, const TelemetryThresholds& thresholds)
+{
+    _intervalMs = intervalMs;
+    _thresholds = thresholds;
+    _lastSample = millis() - intervalMs;
+}
+    
+bool Telemetry::watchTask(const char* name, TaskHandle_t handle)
+{
+    if (_taskCount >= TelemetryRecord::MAX_TASKS || !name) {
+        return false;
+    }
+    
+    _tasks[_taskCount].name = name;
+    _tasks[_taskCount].handle = handle;
+    _tasks[_taskCount].lastRunTime = 0;
+    _taskCount++;
+    return true;
+}
+    
+bool Telemetry::watchQueue(const char* name, QueueHandle_t queue)
+{
+    if (_queueCount >= TelemetryRecord::MAX_QUEUES || !name || !queue) {
+        return false;
+    }
+    
+    _queues[_queueCount].name = name;
+    _queues[_queueCount].queue = queue;
+    _queues[_queueCount].peak = 0;
+    _queueCount++;
+    return true;
+}
+    
+void Telemetry::onWarning(std::function<void(uint8_t, const TelemetryRecord&)> callback)
+{
+    _warningCallback = callback;
+}
+    
+// ============================================================================
+// SAMPLING
+// ============================================================================
+    
+bool Telemetry::update()
+{
+    if (millis() - _lastSample < _intervalMs) {
+        return false;
+    }
+    sample();
+    return true;
+}
+    
+void Telemetry::sample()
+{
+    _lastSample = millis();
+    
+    TelemetryRecord record;
+    memset(&record, 0, sizeof(record));
+    
+    record.uptime = (uint32_t)(esp_timer_get_time() / 1000000);
+    record.freeHeap = heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    record.minFreeHeap = heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    record.largestBlock = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    record.freePsram = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+    
+    // Tasks may start after they were registered; resolve them lazily
+    record.taskCount = _taskCount;
+    for (int i = 0; i < _taskCount; i++) {
+        WatchedTask& task = _tasks[i];
+        if (!task.handle) {
+            task.handle = xTaskGetHandle(task.name);
+        }
+        
+        record.tasks[i].name = task.name;
+        record.tasks[i].cpuPercent = 255;
+        if (task.handle) {
+            // ESP-IDF reports the high-water mark in bytes
+            UBaseType_t free = uxTaskGetStackHighWaterMark(task.handle);
+            record.tasks[i].stackFree = free > 0xFFFF ? 0xFFFF : free;
+        }
+    }
+    sampleCpu(record);
+    
+    record.queueCount = _queueCount;
+    for (int i = 0; i < _queueCount; i++) {
+        WatchedQueue& queue = _queues[i];
+        uint16_t depth = uxQueueMessagesWaiting(queue.queue);
+        if (depth > queue.peak) {
+            queue.peak = depth;
+        }
+        
+        record.queues[i].name = queue.name;
+        record.queues[i].depth = depth;
+        record.queues[i].capacity = depth + uxQueueSpacesAvailable(queue.queue);
+        record.queues[i].peak = queue.peak;
+    }
+    
+    record.warnings = evaluate(record);
+    
+    portENTER_CRITICAL(&_lock);
+    uint8_t previous = _record.warnings;
+    _record = record;
+    portEXIT_CRITICAL(&_lock);
+    
+    report(previous, record);
+}
+    
+void Telemetry::sampleCpu(TelemetryRecord& record)
+{
+#if configGENERATE_RUN_TIME_STATS
+    const UBaseType_t maxTasks = 32;
+    TaskStatus_t* status = (TaskStatus_t*)malloc(maxTasks * sizeof(TaskStatus_t));
+    if (!status) {
+        return;
+    }
+    
+    uint32_t totalRunTime = 0;
+    UBaseType_t count = uxTaskGetSystemState(status, maxTasks, &totalRunTime);
+    uint32_t elapsed = (totalRunTime - _lastTotalRunTime) * portNUM_PROCESSORS;
+    _lastTotalRunTime = totalRunTime;
+    
+    for (int i = 0; i < _taskCount; i++) {
+        for (UBaseType_t t = 0; t < count; t++) {
+            if (status[t].xHandle != _tasks[i].handle) {
+                continue;
+            }
+            
+            uint32_t used = status[t].ulRunTimeCounter - _tasks[i].lastRunTime;
+            _tasks[i].lastRunTime = status[t].ulRunTimeCounter;
+            if (elapsed > 0) {
+                record.tasks[i].cpuPercent = (uint8_t)min<uint64_t>(100, (uint64_t)used * 100 / elapsed);
+            }
+            break;
+        }
+    }
+    free(status);
+#else
+    // Needs CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS; cpuPercent stays 255
+    (void)record;
+#endif
+}
+    
+// ============================================================================
+// WARNINGS
+// ============================================================================
+    
+uint8_t Telemetry::evaluate(const TelemetryRecord& record) const
+{
+    uint8_t warnings = 0;
+    
+    if (record.freeHeap < _thresholds.minFreeHeap) {
+        warnings |= TELEMETRY_WARN_HEAP;
+    }
+    if (record.largestBlock < _thresholds.minLargestBlock) {
+        warnings |= TELEMETRY_WARN_FRAGMENTATION;
+    }
+    for (int i = 0; i < record.taskCount; i++) {
+        if (_tasks[i].handle && record.tasks[i].stackFree < _thresholds.minStackFree) {
+            warnings |= TELEMETRY_WARN_STACK;
+        }
+    }
+    for (int i = 0; i < record.queueCount; i++) {
+        const QueueTelemetry& queue = record.queues[i];
+        if (queue.capacity > 0 && queue.depth * 100u >= queue.capacity * (uint32_t)_thresholds.queueFillPercent) {
+            warnings |= TELEMETRY_WARN_QUEUE;
+        }
+    }
+    
+    return warnings;
+}
+    
+void Telemetry::report(uint8_t previous, const TelemetryRecord& record)
+{
+    uint8_t raised = record.warnings & ~previous;
+    uint8_t cleared = previous & ~record.warnings;
+    
+    for (uint8_t bit = 1; bit <= TELEMETRY_WARN_QUEUE; bit <<= 1) {
+        if (raised & bit) {
+            Serial.printf("[Telemetry] WARNING %s (heap %u, block %u)\n",
+                          warningName((TelemetryWarning)bit), record.freeHeap, record.largestBlock);
+        } else if (cleared & bit) {
+            Serial.printf("[Telemetry] %s back to normal\n", warningName((TelemetryWarning)bit));
+        }
+    }
+    
+    if (raised && _warningCallback) {
+        _warningCallback(raised, record);
+    }
+}
+    
+// ============================================================================
+// QUERIES
+// ============================================================================
+    
+TelemetryRecord Telemetry::getRecord() const
+{
+    portENTER_CRITICAL(&_lock);
+    TelemetryRecord record = _record;
+    portEXIT_CRITICAL(&_lock);
+    return record;
+}
+    
+void Telemetry::toJson(JsonObject out) const
+{
+    TelemetryRecord record = getRecord();
+    
+    out["uptime"] = record.uptime;
+    out["heap"] = record.freeHeap;
+    out["minHeap"] = record.minFreeHeap;
+    out["block"] = record.largestBlock;
+    if (record.freePsram > 0) {
+        out["psram"] = record.freePsram;
+    }
+    
+    JsonArray warnings = out["warnings"].to<JsonArray>();
+    for (uint8_t bit = 1; bit <= TELEMETRY_WARN_QUEUE; bit <<= 1) {
+        if (record.warnings & bit) {
+            warnings.add(warningName((TelemetryWarning)bit));
+        }
+    }
+    
+    JsonArray tasks = out["tasks"].to<JsonArray>();
+    for (int i = 0; i < record.taskCount; i++) {
+        JsonObject task = tasks.add<JsonObject>();
+        task["name"] = record.tasks[i].name;
+        task["stack"] = record.tasks[i].stackFree;
+        if (record.tasks[i].cpuPercent != 255) {
+            task["cpu"] = record.tasks[i].cpuPercent;
+        }
+    }
+    
+    JsonArray queues = out["queues"].to<JsonArray>();
+    for (int i = 0; i < record.queueCount; i++) {
+        JsonObject queue = queues.add<JsonObject>();
+        queue["name"] = record.queues[i].name;
+        queue["depth"] = record.queues[i].depth;
+        queue["peak"] = record.queues[i].peak;
+        queue["size"] = record.queues[i].capacity;
+    }
+}
+    
+const char* Telemetry::warningName(TelemetryWarning warning)
+{
+    switch (warning) {
+        case TELEMETRY_WARN_HEAP: return "heap";
+        case TELEMETRY_WARN_FRAGMENTATION: return "fragmentation";
+        case TELEMETRY_WARN_STACK: return "stack";
+        case TELEMETRY_WARN_QUEUE: return "queue";
+        default: return "unknown";
+    }
+}
+    
+} // namespace VanSight
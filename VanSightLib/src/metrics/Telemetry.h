@@ -0,0 +1,177 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <functional>
+
+namespace VanSight {
+    
+/**
+ * @brief Warning flags raised when a telemetry threshold is crossed
+ */
+enum TelemetryWarning {
+    TELEMETRY_WARN_HEAP = 1 << 0,           // Free heap below minimum
+    TELEMETRY_WARN_FRAGMENTATION = 1 << 1,  // Largest free block below minimum
+    TELEMETRY_WARN_STACK = 1 << 2,          // A watched task is close to its stack end
+    TELEMETRY_WARN_QUEUE = 1 << 3           // A watched queue is nearly full
+};
+    
+/**
+ * @brief Warning thresholds
+ */
+struct TelemetryThresholds {
+    uint32_t minFreeHeap;           // Bytes
+    uint32_t minLargestBlock;       // Bytes
+    uint16_t minStackFree;          // Bytes left at the stack high-water mark
+    uint8_t queueFillPercent;       // Queue depth (percent of capacity)
+};
+    
+/**
+ * @brief Sample of one watched task
+ */
+struct TaskTelemetry {
+    const char* name;
+    uint16_t stackFree;     // Bytes never used so far, 0 if the task is not found
+    uint8_t cpuPercent;     // Share of CPU time since the previous sample, 255 if unknown
+};
+    
+/**
+ * @brief Sample of one watched queue
+ */
+struct QueueTelemetry {
+    const char* name;
+    uint16_t depth;
+    uint16_t capacity;
+    uint16_t peak;          // Highest depth seen at a sample
+};
+    
+/**
+ * @brief One compact telemetry record
+ */
+struct TelemetryRecord {
+    static const int MAX_TASKS = 8;
+    static const int MAX_QUEUES = 4;
+    
+    uint32_t uptime;        // Seconds
+    uint32_t freeHeap;
+    uint32_t minFreeHeap;   // Lowest free heap since boot
+    uint32_t largestBlock;  // Largest allocatable internal block
+    uint32_t freePsram;     // 0 without PSRAM
+    uint8_t taskCount;
+    uint8_t queueCount;
+    uint8_t warnings;       // TelemetryWarning flags
+    TaskTelemetry tasks[MAX_TASKS];
+    QueueTelemetry queues[MAX_QUEUES];
+};
+    
+/**
+ * @brief Periodic runtime resource telemetry
+ *
+ * Samples heap, fragmentation, stack high-water marks of watched tasks,
+ * depths of watched queues and (when FreeRTOS run time stats are
+ * enabled) per-task CPU use into one TelemetryRecord. A warning is
+ * logged when a threshold is crossed and again when it clears.
+ *
+ * Sampling runs in the caller's task; getRecord() is safe from any task.
+ */
+class Telemetry {
+public:
+    /**
+     * @brief Get singleton instance
+     */
+    static Telemetry& getInstance();
+    
+    /**
+     * @brief Set the sample interval and warning thresholds
+     */
+    void begin(uint32_t intervalMs, const TelemetryThresholds& thresholds);
+    
+    /**
+     * @brief Watch a task's stack and CPU use
+     * @param name Task name (must stay valid)
+     * @param handle Task handle, nullptr to look the task up by name
+     * @return false if the table is full
+     */
+    bool watchTask(const char* name, TaskHandle_t handle = nullptr);
+    
+    /**
+     * @brief Watch a queue's depth
+     * @param name Display name (must stay valid)
+     * @param queue Queue handle
+     * @return false if the table is full or queue is null
+     */
+    bool watchQueue(const char* name, QueueHandle_t queue);
+    
+    /**
+     * @brief Sample if the interval has elapsed (call from loop)
+     * @return true if a sample was taken
+     */
+    bool update();
+    
+    /**
+     * @brief Take a sample now
+     */
+    void sample();
+    
+    /**
+     * @brief Get a copy of the latest record
+     */
+    TelemetryRecord getRecord() const;
+    
+    /**
+     * @brief Register callback for newly raised warnings
+     */
+    void onWarning(std::function<void(uint8_t raised, const TelemetryRecord& record)> callback);
+    
+    /**
+     * @brief Write the latest record into a JSON object
+     */
+    void toJson(JsonObject out) const;
+    
+    /**
+     * @brief Get the short name of a warning flag (e.g. "heap")
+     */
+    static const char* warningName(TelemetryWarning warning);
+    
+private:
+    Telemetry();
+    
+    // Prevent copying
+    Telemetry(const Telemetry&) = delete;
+    Telemetry& operator=(const Telemetry&) = delete;
+    
+    struct WatchedTask {
+        const char* name;
+        TaskHandle_t handle;
+        uint32_t lastRunTime;
+    };
+    
+    struct WatchedQueue {
+        const char* name;
+        QueueHandle_t queue;
+        uint16_t peak;
+    };
+    
+    uint32_t _intervalMs;
+    uint32_t _lastSample;
+    TelemetryThresholds _thresholds;
+    
+    WatchedTask _tasks[TelemetryRecord::MAX_TASKS];
+    WatchedQueue _queues[TelemetryRecord::MAX_QUEUES];
+    int _taskCount;
+    int _queueCount;
+    uint32_t _lastTotalRunTime;
+    
+    TelemetryRecord _record;
+    mutable portMUX_TYPE _lock;
+    std::function<void(uint8_t, const TelemetryRecord&)> _warningCallback;
+    
+    void sampleCpu(TelemetryRecord& record);
+    uint8_t evaluate(const TelemetryRecord& record) const;
+    void report(uint8_t previous, const TelemetryRecord& record);
+};
+    
+} // namespace VanSight
+
+#endif // TELEMETRY_H
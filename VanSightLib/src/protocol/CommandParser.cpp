@@ -12,7 +12,18 @@ bool CommandParser::parse(const uint8_t* data, size_t len, Command& cmd) {
         return false;
     }
     
-    return parse(doc, cmd);
+    if (!parse(doc, cmd)) {
+        return false;
+    }
+    
+    // Keep the request for the CommandRegistry
+    if (len >= sizeof(cmd.request)) {
+        Serial.println("[CommandParser] Command too long");
+        return false;
+    }
+    memcpy(cmd.request, data, len);
+    cmd.request[len] = '\0';
+    return true;
 }
 
 bool CommandParser::parse(JsonDocument& doc, Command& cmd) {
@@ -27,15 +38,25 @@ bool CommandParser::parse(JsonDocument& doc, Command& cmd) {
     switch (cmd.type) {
         case CMD_RELAY_TOGGLE:
             return parseRelayToggle(doc, cmd);
+        case CMD_RELAY_SET:
+            return parseRelaySet(doc, cmd);
+        case CMD_RELAYS_SET:
+            return parseRelaysSet(doc, cmd);
         case CMD_ALL_RELAYS_OFF:
             return parseAllRelaysOff(doc, cmd);
         case CMD_ALL_STATUS:
             return parseAllStatus(doc, cmd);
         case CMD_SENSOR_READ:
             return parseSensorRead(doc, cmd);
-        default:
+        case CMD_SCENE_APPLY:
+            strlcpy(cmd.params.scene.name, doc["name"] | "", sizeof(cmd.params.scene.name));
+            return true;
+        case CMD_UNKNOWN:
             Serial.printf("[CommandParser] Unknown command: %s\n", cmdStr);
             return false;
+        default:
+            // Parameters are validated by the registered handler
+            return true;
     }
 }
 
@@ -55,6 +76,63 @@ bool CommandParser::parseRelayToggle(JsonDocument& doc, Command& cmd) {
     return true;
 }
 
+bool CommandParser::parseRelaySet(JsonDocument& doc, Command& cmd) {
+    if (!parseRelayToggle(doc, cmd)) {
+        return false;
+    }
+    
+    uint8_t relayNum = cmd.params.relay.relayNum;
+    bool state;
+    if (!parseState(doc["state"], state)) {
+        Serial.println("[CommandParser] Missing or invalid 'state' parameter");
+        return false;
+    }
+    
+    cmd.params.relaySet.relayNum = relayNum;
+    cmd.params.relaySet.state = state;
+    return true;
+}
+
+bool CommandParser::parseRelaysSet(JsonDocument& doc, Command& cmd) {
+    if (!doc["mask"].is<unsigned int>() || !doc["values"].is<unsigned int>()) {
+        Serial.println("[CommandParser] Missing 'mask' or 'values' parameter");
+        return false;
+    }
+    
+    uint32_t mask = doc["mask"];
+    uint32_t values = doc["values"];
+    
+    // Only relays that exist; values outside the mask are ignored
+    RelayMask valid = (RelayMask)((1u << MAX_RELAYS) - 1);
+    if (mask == 0 || (mask & ~(uint32_t)valid)) {
+        Serial.printf("[CommandParser] Invalid relay mask: 0x%X\n", (unsigned)mask);
+        return false;
+    }
+    
+    cmd.params.relays.mask = (RelayMask)mask;
+    cmd.params.relays.values = (RelayMask)(values & mask);
+    return true;
+}
+
+bool CommandParser::parseState(JsonVariantConst value, bool& state) {
+    // "on"/"off" like the responses, or a plain bool / 0-1
+    if (value.is<const char*>()) {
+        const char* text = value.as<const char*>();
+        if (strcmp(text, "on") == 0) { state = true; return true; }
+        if (strcmp(text, "off") == 0) { state = false; return true; }
+        return false;
+    }
+    if (value.is<bool>()) {
+        state = value.as<bool>();
+        return true;
+    }
+    if (value.is<int>()) {
+        state = value.as<int>() != 0;
+        return true;
+    }
+    return false;
+}
+
 bool CommandParser::parseAllRelaysOff(JsonDocument& doc, Command& cmd) {
     // No parameters needed
     return true;
@@ -13,6 +13,10 @@ class CommandParser {
 public:
     /**
      * @brief Parse JSON data into Command structure
+     * 
+     * Also keeps a copy of the request in cmd.request for the
+     * CommandRegistry; requests that do not fit are rejected.
+     * 
      * @param data Raw JSON data
      * @param len Length of data
      * @param cmd Output command structure
@@ -27,9 +31,22 @@ public:
      * @return true if parsing successful
      */
     static bool parse(JsonDocument& doc, Command& cmd);
+    
+    /**
+     * @brief Parse a relay state value
+     * 
+     * Accepts "on"/"off", true/false or 1/0.
+     * 
+     * @param value JSON value
+     * @param state Output state
+     * @return true if the value is a valid state
+     */
+    static bool parseState(JsonVariantConst value, bool& state);
 
 private:
     static bool parseRelayToggle(JsonDocument& doc, Command& cmd);
+    static bool parseRelaySet(JsonDocument& doc, Command& cmd);
+    static bool parseRelaysSet(JsonDocument& doc, Command& cmd);
     static bool parseAllRelaysOff(JsonDocument& doc, Command& cmd);
     static bool parseAllStatus(JsonDocument& doc, Command& cmd);
     static bool parseSensorRead(JsonDocument& doc, Command& cmd);
@@ -0,0 +1,78 @@
+#include "CommandRegistry.h"
+#include "../metrics/LatencyMetrics.h"
+
+namespace VanSight {
+    
+CommandRegistry& CommandRegistry::getInstance() {
+    static CommandRegistry instance;
+    return instance;
+}
+    
+CommandRegistry::CommandRegistry()
+    : _dispatchedCallback(nullptr) {
+}
+    
+void CommandRegistry::on(CommandType type, CommandHandlerFn handler) {
+    if ((int)type < 0 || type >= CMD_COUNT) {
+        return;
+    }
+    _handlers[type] = handler;
+}
+    
+bool CommandRegistry::has(CommandType type) const {
+    return (int)type >= 0 && type < CMD_COUNT && _handlers[type];
+}
+    
+void CommandRegistry::onDispatched(std::function<void(CommandType)> callback) {
+    _dispatchedCallback = callback;
+}
+    
+bool CommandRegistry::dispatch(JsonDocument& request, JsonDocument& response) {
+    const char* name = request["cmd"];
+    if (!name) {
+        error(response, "Missing 'cmd' field");
+        return false;
+    }
+    
+    // Parsed and run in one go: this is where the command arrived
+    CommandType type = stringToCommandType(name);
+    LatencyMetrics::getInstance().stamp(type, STAGE_HUB_RX);
+    return run(type, request, response);
+}
+    
+bool CommandRegistry::dispatch(const Command& cmd, JsonDocument& response) {
+    JsonDocument request;
+    if (deserializeJson(request, cmd.request) != DeserializationError::Ok) {
+        error(response, "Invalid JSON format");
+        return false;
+    }
+    
+    return run(cmd.type, request, response);
+}
+    
+bool CommandRegistry::run(CommandType type, JsonDocument& request, JsonDocument& response) {
+    if (!has(type)) {
+        error(response, "Unknown command");
+        return false;
+    }
+    
+    LatencyMetrics& metrics = LatencyMetrics::getInstance();
+    metrics.stamp(type, STAGE_HANDLER_START);
+    
+    _handlers[type](request, response);
+    response["cmd"] = commandTypeToString(type);
+    
+    if (_dispatchedCallback) {
+        _dispatchedCallback(type);
+    }
+    metrics.stamp(type, STAGE_HANDLER_END);
+    return true;
+}
+    
+void CommandRegistry::error(JsonDocument& response, const char* message) {
+    response["status"] = "error";
+    response["data"].to<JsonObject>();  // Empty data object
+    response["message"] = message;
+}
+    
+} // namespace VanSight
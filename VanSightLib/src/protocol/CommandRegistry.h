@@ -0,0 +1,92 @@
+#ifndef COMMAND_REGISTRY_H
+#define COMMAND_REGISTRY_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <functional>
+#include "VanSightProtocol.h"
+
+namespace VanSight {
+    
+/**
+ * @brief Handler of one command
+ * 
+ * Gets the parsed JSON request and fills the response document
+ * ({"status", "data", "message"}).
+ */
+typedef std::function<void(JsonDocument& request, JsonDocument& response)> CommandHandlerFn;
+    
+/**
+ * @brief Table of command handlers keyed by CommandType
+ * 
+ * The one place a device implements its commands. Every transport
+ * (BLE, ESP-NOW, WebSocket) resolves the command ID and dispatches into
+ * the same table, so all commands are reachable from all transports.
+ * 
+ * Every response names its command in "cmd". Relay changes are not part
+ * of the response: clients get them from the relay broadcast.
+ */
+class CommandRegistry {
+public:
+    /**
+     * @brief Get singleton instance
+     */
+    static CommandRegistry& getInstance();
+    
+    /**
+     * @brief Register (or replace) the handler of a command
+     */
+    void on(CommandType type, CommandHandlerFn handler);
+    
+    /**
+     * @brief Check if a command has a handler
+     */
+    bool has(CommandType type) const;
+    
+    /**
+     * @brief Register callback that runs after every dispatched command
+     * 
+     * Used to publish side effects (e.g. relay changes) once, regardless
+     * of the transport the command came from.
+     */
+    void onDispatched(std::function<void(CommandType type)> callback);
+    
+    /**
+     * @brief Dispatch a parsed request by its "cmd" field
+     * 
+     * Stamps STAGE_HUB_RX; every dispatch stamps the handler stages.
+     * @return true if a handler ran, false if the command is unknown
+     *         (response then holds an error)
+     */
+    bool dispatch(JsonDocument& request, JsonDocument& response);
+    
+    /**
+     * @brief Dispatch a command carrying its original JSON request
+     * 
+     * The transport stamps STAGE_HUB_RX when it parsed the command, so
+     * the time spent queued is measured too.
+     * @return true if a handler ran
+     */
+    bool dispatch(const Command& cmd, JsonDocument& response);
+    
+    /**
+     * @brief Fill an error response
+     */
+    static void error(JsonDocument& response, const char* message);
+    
+private:
+    CommandRegistry();
+    
+    // Prevent copying
+    CommandRegistry(const CommandRegistry&) = delete;
+    CommandRegistry& operator=(const CommandRegistry&) = delete;
+    
+    CommandHandlerFn _handlers[CMD_COUNT];
+    std::function<void(CommandType)> _dispatchedCallback;
+    
+    bool run(CommandType type, JsonDocument& request, JsonDocument& response);
+};
+    
+} // namespace VanSight
+
+#endif // COMMAND_REGISTRY_H
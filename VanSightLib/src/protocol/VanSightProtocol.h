@@ -1,16 +1,46 @@
 #ifndef VANSIGHT_PROTOCOL_H
 #define VANSIGHT_PROTOCOL_H
 
+#ifdef ARDUINO
 #include <Arduino.h>
+#else
+#include <stdint.h>
+#include <string.h>
+#endif
 
 namespace VanSight {
 
 // Command Types
+// IDs are part of the protocol: append new commands, never renumber
 enum CommandType {
     CMD_RELAY_TOGGLE = 0,
     CMD_ALL_RELAYS_OFF = 1,
     CMD_ALL_STATUS = 2,
     CMD_SENSOR_READ = 3,
+    CMD_SCENE_APPLY = 4,
+    CMD_RELAY_ON = 5,
+    CMD_RELAY_OFF = 6,
+    CMD_RELAY_STATUS = 7,
+    CMD_ALL_RELAYS_ON = 8,
+    CMD_ALL_RELAY_STATUS = 9,
+    CMD_ALL_SENSOR_STATUS = 10,
+    CMD_CALIBRATE_POINT = 11,
+    CMD_CALIBRATE_CLEAR = 12,
+    CMD_CALIBRATION_STATUS = 13,
+    CMD_SENSOR_HISTORY = 14,
+    CMD_RELAY_HISTORY = 15,
+    CMD_SCENE_SAVE = 16,
+    CMD_SCENE_DELETE = 17,
+    CMD_SCENE_LIST = 18,
+    CMD_TIMER_ADD = 19,
+    CMD_RELAY_PULSE = 20,
+    CMD_TIMER_CANCEL = 21,
+    CMD_TIMER_LIST = 22,
+    CMD_METRICS = 23,
+    CMD_TELEMETRY = 24,
+    CMD_RELAY_SET = 25,
+    CMD_RELAYS_SET = 26,
+    CMD_COUNT,
     CMD_UNKNOWN = 255
 };
 
@@ -23,6 +53,13 @@ enum ResponseStatus {
     STATUS_TIMEOUT = 4
 };
 
+// Relay states packed one bit per relay (bit 0 = relay 1)
+typedef uint16_t RelayMask;
+
+inline RelayMask relayBit(uint8_t relayNum) {
+    return (RelayMask)(1u << (relayNum - 1));
+}
+
 // Command Structure
 struct Command {
     CommandType type;
@@ -30,12 +67,27 @@ struct Command {
         struct {
             uint8_t relayNum;  // For CMD_RELAY_TOGGLE
         } relay;
+        struct {
+            uint8_t relayNum;  // For CMD_RELAY_SET
+            bool state;
+        } relaySet;
+        struct {
+            RelayMask mask;    // For CMD_RELAYS_SET: relays to set
+            RelayMask values;  // Target states of the relays in mask
+        } relays;
         struct {
             uint8_t sensorNum; // For CMD_SENSOR_READ
         } sensor;
+        struct {
+            char name[16];     // For CMD_SCENE_APPLY
+        } scene;
     } params;
     
-    Command() : type(CMD_UNKNOWN) {}
+    // Original JSON request, so any command can be handed to the
+    // CommandRegistry (also after queueing)
+    char request[192];
+    
+    Command() : type(CMD_UNKNOWN) { request[0] = '\0'; }
 };
 
 // Response Structure
@@ -59,23 +111,33 @@ struct Response {
     Response() : status(STATUS_OK) {}
 };
 
+// Wire names indexed by CommandType
+inline const char* const* commandNames() {
+    static const char* const names[CMD_COUNT] = {
+        "relay_toggle", "all_relays_off", "all_status", "sensor_read", "scene_apply",
+        "relay_on", "relay_off", "relay_status", "all_relays_on", "all_relay_status",
+        "all_sensor_status", "calibrate_point", "calibrate_clear", "calibration_status",
+        "sensor_history", "relay_history", "scene_save", "scene_delete", "scene_list",
+        "timer_add", "relay_pulse", "timer_cancel", "timer_list", "metrics", "telemetry",
+        "relay_set", "relays_set"
+    };
+    return names;
+}
+
 // Helper function to convert CommandType to string
 inline const char* commandTypeToString(CommandType type) {
-    switch (type) {
-        case CMD_RELAY_TOGGLE: return "relay_toggle";
-        case CMD_ALL_RELAYS_OFF: return "all_relays_off";
-        case CMD_ALL_STATUS: return "all_status";
-        case CMD_SENSOR_READ: return "sensor_read";
-        default: return "unknown";
-    }
+    if ((int)type < 0 || type >= CMD_COUNT) return "unknown";
+    return commandNames()[type];
 }
 
 // Helper function to convert string to CommandType
 inline CommandType stringToCommandType(const char* str) {
-    if (strcmp(str, "relay_toggle") == 0) return CMD_RELAY_TOGGLE;
-    if (strcmp(str, "all_relays_off") == 0) return CMD_ALL_RELAYS_OFF;
-    if (strcmp(str, "all_status") == 0) return CMD_ALL_STATUS;
-    if (strcmp(str, "sensor_read") == 0) return CMD_SENSOR_READ;
+    if (!str) return CMD_UNKNOWN;
+    for (int i = 0; i < CMD_COUNT; i++) {
+        if (strcmp(str, commandNames()[i]) == 0) return (CommandType)i;
+    }
+    // Dashboard name of sensor_read
+    if (strcmp(str, "sensor_status") == 0) return CMD_SENSOR_READ;
     return CMD_UNKNOWN;
 }
 